@@ -0,0 +1,115 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file fuzz_download.c
+*
+* Fuzz target of cellular_esim_download_profile_with_activationcode,
+* cellular_esim_download_profile_from_smds and cellular_esim_download_profile_from_defaultsmdp.
+* Input layout:
+*
+*     u8 selector, string bytes
+*
+* selector % 3 picks the API, bit 2 passes NULL instead of the string. The string is NUL terminated
+* in an exact size allocation. The progress values of the activation code download are checked to
+* stay within 0 - 100. Addresses the simulator would post to a live SM-DP+ ("<host>:<port>") are
+* skipped, the loopback exchange is covered by the performance suite.
+*/
+
+#include <string.h>
+#include "lpa_fuzz.h"
+
+static void fuzz_progress(int progress)
+{
+    if ((progress < 0) || (progress > 100))
+    {
+        abort();
+    }
+}
+
+/* The SM-DP+ address of "1$<address>$<matching id>", the whole string otherwise */
+static int fuzz_download_remote(int api, const char *text)
+{
+    const char *address = text;
+    const char *end = NULL;
+
+    if (api == 0)
+    {
+        if (strncmp(text, "1$", 2))
+        {
+            return 0;
+        }
+        address = text + 2;
+    }
+    end = (api == 0) ? strchr(address, '$') : NULL;
+    return lpa_fuzz_remote_address(address, (end != NULL) ? (size_t)(end - address) : strlen(address));
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+    lpa_fuzz_init();
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *text = NULL;
+    int api = 0;
+    int result = 0;
+
+    if (size < 1)
+    {
+        return 0;
+    }
+    api = data[0] % 3;
+    if ((data[0] & 0x04) == 0)
+    {
+        text = (char *)malloc(size);
+        if (text == NULL)
+        {
+            return 0;
+        }
+        memcpy(text, data + 1, size - 1);
+        text[size - 1] = '\0';
+        if (fuzz_download_remote(api, text))
+        {
+            free(text);
+            return 0;
+        }
+    }
+    switch (api)
+    {
+        case 0:
+            result = cellular_esim_download_profile_with_activationcode(text, fuzz_progress);
+            break;
+        case 1:
+            result = cellular_esim_download_profile_from_smds(text);
+            break;
+        default:
+            result = cellular_esim_download_profile_from_defaultsmdp(text);
+            break;
+    }
+    if ((result != RETURN_OK) && (result != RETURN_ERROR))
+    {
+        abort();
+    }
+    free(text);
+    return 0;
+}
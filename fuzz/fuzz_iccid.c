@@ -0,0 +1,98 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file fuzz_iccid.c
+*
+* Fuzz target of cellular_esim_enable_profile, cellular_esim_disable_profile and
+* cellular_esim_delete_profile. Input layout:
+*
+*     u8 selector, i16 iccid_size (little endian), iccid bytes
+*
+* selector % 3 picks the API. Bit 2 passes a NULL iccid. Bit 3 passes the bytes without a
+* terminating NUL and iccid_size set to their length, the tightest buffer the API contract allows.
+* Otherwise the bytes are NUL terminated and iccid_size is taken as is, negative and oversized
+* values included.
+*/
+
+#include <string.h>
+#include "lpa_fuzz.h"
+
+#define FUZZ_ICCID_HEADER  3
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+    lpa_fuzz_init();
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *iccid = NULL;
+    size_t len = 0;
+    int iccid_size = 0;
+    int result = 0;
+
+    if (size < FUZZ_ICCID_HEADER)
+    {
+        return 0;
+    }
+    len = size - FUZZ_ICCID_HEADER;
+    iccid_size = (int16_t)(data[1] | (data[2] << 8));
+    if ((data[0] & 0x04) == 0)
+    {
+        int terminated = ((data[0] & 0x08) == 0);
+
+        /* exact size allocation, ASan catches any read past it */
+        iccid = (char *)malloc(len + (size_t)terminated);
+        if ((iccid == NULL) || (len + (size_t)terminated == 0))
+        {
+            free(iccid);
+            return 0;
+        }
+        memcpy(iccid, data + FUZZ_ICCID_HEADER, len);
+        if (terminated)
+        {
+            iccid[len] = '\0';
+        }
+        else
+        {
+            iccid_size = (int)len;
+        }
+    }
+    switch (data[0] % 3)
+    {
+        case 0:
+            result = cellular_esim_enable_profile(iccid, iccid_size);
+            break;
+        case 1:
+            result = cellular_esim_disable_profile(iccid, iccid_size);
+            break;
+        default:
+            result = cellular_esim_delete_profile(iccid, iccid_size);
+            break;
+    }
+    if ((result != RETURN_OK) && (result != RETURN_ERROR))
+    {
+        abort();
+    }
+    free(iccid);
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_fuzz.h
+*
+* Shared by the fuzz targets, built with `make fuzz` (libFuzzer, clang) or `make fuzz FUZZ_ENGINE=standalone`
+* (lpa_fuzz_main.c, any compiler). Each target defines LLVMFuzzerTestOneInput() and calls the HAL
+* in process, the eUICC simulator of skeletons/src on Linux.
+*/
+
+#ifndef LPA_FUZZ_H
+#define LPA_FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "lpa_hal.h"
+
+int LLVMFuzzerInitialize(int *argc, char ***argv);
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/* No simulated latency, then one init for the whole run */
+static inline void lpa_fuzz_init(void)
+{
+    setenv("LPA_SIM_LATENCY_US", "default=0", 1);
+    if (cellular_esim_lpa_init() != RETURN_OK)
+    {
+        abort();
+    }
+}
+
+/**
+ * @brief 1 for "<host>:<port>", which the simulator posts to a live SM-DP+ and the targets skip
+ */
+static inline int lpa_fuzz_remote_address(const char *address, size_t len)
+{
+    size_t i = len;
+
+    while ((i > 0) && isdigit((unsigned char)address[i - 1]))
+    {
+        i--;
+    }
+    return (i > 1) && (i < len) && (address[i - 1] == ':');
+}
+
+#endif /* LPA_FUZZ_H */
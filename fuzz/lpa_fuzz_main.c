@@ -0,0 +1,217 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_fuzz_main.c
+*
+* Driver of the fuzz targets when libFuzzer is not available (`make fuzz FUZZ_ENGINE=standalone`):
+*
+*     fuzz_<target> [-seconds N] [-seed S] [file or directory ...]
+*
+* With files or directories, each file is run once, to replay a corpus or a crash on a gcc build.
+* Without, random inputs biased towards digits, host names and activation code separators are
+* generated for N seconds (default 10), without coverage feedback. The execs/sec is printed every
+* second and at the end, as libFuzzer does.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "lpa_fuzz.h"
+
+#define FUZZ_MAX_INPUT  128
+
+static const char fuzz_alphabet[] = "0123456789$.-:abcdefxyz@#ABC";
+static const char *const fuzz_token[] = { "1$", "$", "smdp.example.com", "8949", "89014103211118510720", ":", "" };
+
+static uint64_t fuzz_execs = 0;
+
+static double fuzz_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t fuzz_random(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static size_t fuzz_generate(uint8_t *data, uint32_t *state)
+{
+    size_t size = 0;
+    size_t target = 1 + fuzz_random(state) % FUZZ_MAX_INPUT;
+
+    /* header bytes (selector, sizes) stay fully random */
+    while ((size < target) && (size < 3))
+    {
+        data[size++] = (uint8_t)fuzz_random(state);
+    }
+    while (size < target)
+    {
+        uint32_t pick = fuzz_random(state) % 16;
+
+        if (pick == 0)
+        {
+            data[size++] = (uint8_t)fuzz_random(state);
+        }
+        else if (pick < 4)
+        {
+            const char *token = fuzz_token[fuzz_random(state) % (sizeof(fuzz_token) / sizeof(fuzz_token[0]))];
+            size_t len = strlen(token);
+
+            if (size + len > target)
+            {
+                len = target - size;
+            }
+            memcpy(data + size, token, len);
+            size += len;
+        }
+        else
+        {
+            data[size++] = (uint8_t)fuzz_alphabet[fuzz_random(state) % (sizeof(fuzz_alphabet) - 1)];
+        }
+    }
+    return size;
+}
+
+static void fuzz_run_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long size = 0;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = (uint8_t *)malloc((size > 0) ? (size_t)size : 1);
+    if ((data != NULL) && (fread(data, 1, (size_t)size, file) == (size_t)size))
+    {
+        LLVMFuzzerTestOneInput(data, (size_t)size);
+        fuzz_execs++;
+    }
+    free(data);
+    fclose(file);
+}
+
+static void fuzz_run_path(const char *path)
+{
+    struct stat st;
+    struct dirent *entry = NULL;
+    DIR *dir = NULL;
+    char file[4096];
+
+    if ((stat(path, &st) != 0) || !S_ISDIR(st.st_mode))
+    {
+        fuzz_run_file(path);
+        return;
+    }
+    dir = opendir(path);
+    if (dir == NULL)
+    {
+        return;
+    }
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+        snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+        fuzz_run_file(file);
+    }
+    closedir(dir);
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t data[FUZZ_MAX_INPUT];
+    uint32_t state = 0x9e3779b9u;
+    double seconds = 10.0;
+    double start = 0;
+    double next = 0;
+    double now = 0;
+    int paths = 0;
+    int i = 0;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-seconds") && (i + 1 < argc))
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-seed") && (i + 1 < argc))
+        {
+            state = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (state == 0)
+            {
+                state = 1;
+            }
+        }
+    }
+    LLVMFuzzerInitialize(&argc, &argv);
+    start = fuzz_now();
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-seconds") || !strcmp(argv[i], "-seed"))
+        {
+            i++;
+            continue;
+        }
+        fuzz_run_path(argv[i]);
+        paths++;
+    }
+    if (paths == 0)
+    {
+        next = start + 1.0;
+        do
+        {
+            size_t size = fuzz_generate(data, &state);
+
+            LLVMFuzzerTestOneInput(data, size);
+            fuzz_execs++;
+            if ((fuzz_execs & 0xff) == 0)
+            {
+                now = fuzz_now();
+                if (now >= next)
+                {
+                    printf("#%llu\texec/s: %.0f\n", (unsigned long long)fuzz_execs, (double)fuzz_execs / (now - start));
+                    fflush(stdout);
+                    next += 1.0;
+                }
+            }
+        } while ((fuzz_execs & 0xff) || (fuzz_now() - start < seconds));
+    }
+    now = fuzz_now();
+    printf("Done %llu runs in %.1f s, exec/s: %.0f\n", (unsigned long long)fuzz_execs, now - start,
+           (now > start) ? (double)fuzz_execs / (now - start) : 0.0);
+    return 0;
+}
@@ -16,87 +16,752 @@
 * limitations under the License.
 */
 
+/**
+* @file lpa_hal.c
+*
+* In-memory eUICC simulator implementing lpa_hal.h, linked when TARGET is linux.
+*
+* The simulator keeps a profile table, enforces the profile state machine and returns a
+* heap allocated eSIMProfileStruct array from cellular_esim_get_profile_info (the caller frees it).
+*
+* - cellular_esim_enable_profile enables the profile and disables the previously enabled one
+* - enable of an enabled profile and disable of a disabled profile are accepted as no-ops
+* - cellular_esim_delete_profile is refused while the profile is enabled
+* - every API except init/exit fails until cellular_esim_lpa_init has been called
+*
+* Configuration is read from the environment on every cellular_esim_lpa_init:
+* - LPA_SIM_ICCIDS : comma separated iccids seeding the profile table, re-seeded by every init
+*   that follows an exit (or when the value changes), so deleted profiles come back
+* - LPA_SIM_CONFIG : lpa_config file whose "iccid" array seeds the profile table instead, for tables
+*   too large for the environment (see `lpa_hal_test --gen-config`)
+* - LPA_SIM_LATENCY_US : per-operation latency, e.g. "enable=2000,disable=1500,get_profile_info=200".
+*   Keys are download, get_profile_info, enable, disable, delete, init, exit, get_eid, get_euicc and default.
+* - LPA_SIM_SERIALIZE : 1 (default) holds the global lock while the latency elapses, like a single modem
+*   channel would, 0 lets concurrent callers overlap
+*
+* A download address carrying a port ("127.0.0.1:8080", also inside an activation code) is contacted
+* for real: one HTTP POST of the ES9+ / ES11 InitiateAuthentication call, and the download fails unless
+* the server answers 200. This pairs with the loopback SM-DP+ stand-in of the test suite.
+*/
+
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <setjmp.h>
+#include <ctype.h>
+#include <time.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include "lpa_hal.h"
+#include "lpa_trace.h"
+#include "lpa_iccid.h"
+
+#define SIM_ICCID_MIN_LEN   18
+#define SIM_ICCID_MAX_LEN   20
+#define SIM_DOWNLOAD_STEPS  4
+#define SIM_HTTP_TIMEOUT_S  30
+
+#define SIM_ES9_PATH   "/gsma/rsp2/es9plus/initiateAuthentication"
+#define SIM_ES11_PATH  "/gsma/rsp2/es11/initiateAuthentication"
+
+/* 20 digit, Luhn valid iccids used when LPA_SIM_ICCIDS is not set */
+#define SIM_DEFAULT_ICCIDS  "89012608822888888809,89014103211118510720"
+
+typedef enum
+{
+  SIM_OP_DOWNLOAD = 0,
+  SIM_OP_GET_PROFILE_INFO,
+  SIM_OP_ENABLE,
+  SIM_OP_DISABLE,
+  SIM_OP_DELETE,
+  SIM_OP_INIT,
+  SIM_OP_EXIT,
+  SIM_OP_GET_EID,
+  SIM_OP_GET_EUICC,
+  SIM_OP_MAX
+} sim_op_t;
+
+static const char *sim_op_name[SIM_OP_MAX] =
+{
+  "download", "get_profile_info", "enable", "disable", "delete", "init", "exit", "get_eid", "get_euicc"
+};
+
+static const char *sim_profile_names[] = { "Xfinity Mobile", "Comcast", "CRTC" };
+
+typedef struct
+{
+  lpa_iccid_t key;
+  char iccid[SIM_ICCID_MAX_LEN + 1];
+  const char *profileName;
+  int profileState;
+} sim_profile_t;
+
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static sim_profile_t *sim_profiles = NULL;
+static int sim_nb_profiles = 0;
+static char *sim_seed = NULL;
+static int sim_initialized = 0;
+static int sim_serialize = 1;
+static long sim_latency_us[SIM_OP_MAX];
+
+static void sim_sleep_us(long us)
+{
+  struct timespec ts;
+
+  if (us <= 0)
+  {
+    return;
+  }
+  ts.tv_sec = us / 1000000L;
+  ts.tv_nsec = (us % 1000000L) * 1000L;
+  while (nanosleep(&ts, &ts) != 0)
+  {
+    /* resume after EINTR with the remaining time */
+  }
+}
+
+/* Takes the global lock, and sleeps the configured latency either inside or outside of it */
+static void sim_enter(sim_op_t op)
+{
+  if (!sim_serialize)
+  {
+    LPA_TRACE_BEGIN("sim latency");
+    sim_sleep_us(sim_latency_us[op]);
+    LPA_TRACE_END("sim latency");
+  }
+  LPA_TRACE_BEGIN("sim lock wait");
+  pthread_mutex_lock(&sim_lock);
+  LPA_TRACE_END("sim lock wait");
+  if (sim_serialize)
+  {
+    LPA_TRACE_BEGIN("sim latency");
+    sim_sleep_us(sim_latency_us[op]);
+    LPA_TRACE_END("sim latency");
+  }
+}
+
+static void sim_leave(void)
+{
+  pthread_mutex_unlock(&sim_lock);
+}
+
+static void sim_parse_latency(const char *spec)
+{
+  const char *p = spec;
+  long def = 0;
+  int i = 0;
+  long overrides[SIM_OP_MAX];
+
+  for (i = 0; i < SIM_OP_MAX; i++)
+  {
+    overrides[i] = -1;
+  }
+  while ((p != NULL) && (*p != '\0'))
+  {
+    const char *eq = strchr(p, '=');
+    const char *next = strchr(p, ',');
+    size_t key_len = 0;
+    long value = 0;
+
+    if ((eq == NULL) || ((next != NULL) && (next < eq)))
+    {
+      break;
+    }
+    key_len = (size_t)(eq - p);
+    value = strtol(eq + 1, NULL, 10);
+    if (key_len == strlen("default") && !strncmp(p, "default", key_len))
+    {
+      def = value;
+    }
+    for (i = 0; i < SIM_OP_MAX; i++)
+    {
+      if (key_len == strlen(sim_op_name[i]) && !strncmp(p, sim_op_name[i], key_len))
+      {
+        overrides[i] = value;
+      }
+    }
+    p = (next != NULL) ? next + 1 : NULL;
+  }
+  for (i = 0; i < SIM_OP_MAX; i++)
+  {
+    sim_latency_us[i] = (overrides[i] >= 0) ? overrides[i] : def;
+  }
+}
+
+/* Digits only, SIM_ICCID_MIN_LEN to SIM_ICCID_MAX_LEN long within the first iccid_size bytes */
+static int sim_iccid_valid(const char *iccid, int iccid_size)
+{
+  size_t len = 0;
+  size_t i = 0;
+
+  if ((iccid == NULL) || (iccid_size <= 0))
+  {
+    return 0;
+  }
+  len = strnlen(iccid, (size_t)iccid_size);
+  if ((len < SIM_ICCID_MIN_LEN) || (len > SIM_ICCID_MAX_LEN))
+  {
+    return 0;
+  }
+  for (i = 0; i < len; i++)
+  {
+    if (!isdigit((unsigned char)iccid[i]))
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static sim_profile_t *sim_find(const char *iccid, int iccid_size)
+{
+  lpa_iccid_t key;
+  int i = 0;
+
+  /* packed as in EF.ICCID, so a lookup compares LPA_ICCID_BCD_BYTES bytes */
+  if (lpa_iccid_pack(iccid, strnlen(iccid, (size_t)iccid_size), &key) != LPA_ICCID_OK)
+  {
+    return NULL;
+  }
+  for (i = 0; i < sim_nb_profiles; i++)
+  {
+    if (!lpa_iccid_compare(&sim_profiles[i].key, &key))
+    {
+      return &sim_profiles[i];
+    }
+  }
+  return NULL;
+}
+
+/* (Re)builds the profile table from a comma separated iccid list, the first profile starts enabled */
+static int sim_seed_profiles(const char *list)
+{
+  const char *p = list;
+  int count = 1;
+  int n = 0;
+
+  while ((p = strchr(p, ',')) != NULL)
+  {
+    count++;
+    p++;
+  }
+  free(sim_profiles);
+  sim_profiles = (sim_profile_t *)calloc((size_t)count, sizeof(sim_profile_t));
+  sim_nb_profiles = 0;
+  if (sim_profiles == NULL)
+  {
+    return -1;
+  }
+  p = list;
+  while (*p != '\0')
+  {
+    size_t len = strcspn(p, ",");
+
+    if (sim_iccid_valid(p, (int)len))
+    {
+      memcpy(sim_profiles[n].iccid, p, len);
+      sim_profiles[n].iccid[len] = '\0';
+      lpa_iccid_pack(p, len, &sim_profiles[n].key);
+      sim_profiles[n].profileName = sim_profile_names[n % (sizeof(sim_profile_names) / sizeof(sim_profile_names[0]))];
+      sim_profiles[n].profileState = (n == 0) ? 1 : 0;
+      n++;
+    }
+    p += len;
+    if (*p == ',')
+    {
+      p++;
+    }
+  }
+  sim_nb_profiles = n;
+  return 0;
+}
+
+/* The strings of the "iccid" array of an lpa_config file as a comma separated list, NULL when unreadable */
+static char *sim_read_config(const char *path)
+{
+  FILE *file = fopen(path, "r");
+  char *text = NULL;
+  char *list = NULL;
+  char *p = NULL;
+  char *end = NULL;
+  size_t used = 0;
+  long size = 0;
+
+  if (file == NULL)
+  {
+    return NULL;
+  }
+  if ((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) >= 0) && (fseek(file, 0, SEEK_SET) == 0))
+  {
+    text = (char *)malloc((size_t)size + 1);
+    list = (char *)malloc((size_t)size + 1);
+  }
+  if ((text == NULL) || (list == NULL) || (fread(text, 1, (size_t)size, file) != (size_t)size))
+  {
+    fclose(file);
+    free(text);
+    free(list);
+    return NULL;
+  }
+  fclose(file);
+  text[size] = '\0';
+  list[0] = '\0';
+  p = strstr(text, "\"iccid\"");
+  p = (p != NULL) ? strchr(p, '[') : NULL;
+  end = (p != NULL) ? strchr(p, ']') : NULL;
+  while ((p != NULL) && (end != NULL) && ((p = strchr(p, '"')) != NULL) && (p < end))
+  {
+    char *close = strchr(p + 1, '"');
+
+    if (close == NULL)
+    {
+      break;
+    }
+    if (used > 0)
+    {
+      list[used++] = ',';
+    }
+    memcpy(list + used, p + 1, (size_t)(close - p - 1));
+    used += (size_t)(close - p - 1);
+    p = close + 1;
+  }
+  list[used] = '\0';
+  free(text);
+  return list;
+}
+
+/* Host name / address characters only, which is all the simulator accepts as an SM-DS or SM-DP+ */
+static int sim_address_valid(const char *address, size_t len)
+{
+  size_t i = 0;
+
+  if ((address == NULL) || (len == 0))
+  {
+    return 0;
+  }
+  for (i = 0; i < len; i++)
+  {
+    if (!isalnum((unsigned char)address[i]) && (address[i] != '.') && (address[i] != '-') && (address[i] != ':'))
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static int sim_http_send(int fd, const char *data, size_t len)
+{
+  ssize_t sent = 0;
+
+  while (len > 0)
+  {
+    sent = send(fd, data, len, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (sent <= 0)
+    {
+      return -1;
+    }
+    data += sent;
+    len -= (size_t)sent;
+  }
+  return 0;
+}
+
+/* Connects to host:port, bounded by SIM_HTTP_TIMEOUT_S for every socket operation */
+static int sim_http_connect(const char *host, const char *port)
+{
+  struct addrinfo hints;
+  struct addrinfo *list = NULL;
+  struct addrinfo *ai = NULL;
+  struct timeval timeout = { SIM_HTTP_TIMEOUT_S, 0 };
+  int fd = -1;
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host, port, &hints, &list) != 0)
+  {
+    return -1;
+  }
+  for (ai = list; ai != NULL; ai = ai->ai_next)
+  {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0)
+    {
+      continue;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+    {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(list);
+  return fd;
+}
+
+/**
+ * Posts an InitiateAuthentication request when `address` ends with ":<port>"
+ * Returns 1 for an address without port (simulated locally), 0 on HTTP 200, -1 otherwise
+ */
+static int sim_remote_exchange(const char *address, size_t len, const char *path)
+{
+  char host[256];
+  char port[8];
+  /* headers and body hold the address twice, at most sizeof(host) + sizeof(port) bytes each */
+  char request[512 + 2 * (256 + 8)];
+  char response[4096];
+  int request_len = 0;
+  const char *colon = NULL;
+  size_t used = 0;
+  ssize_t got = 0;
+  int status = 0;
+  int body_len = 0;
+  int fd = -1;
+  size_t i = 0;
 
+  for (i = len; i > 0; i--)
+  {
+    if (address[i - 1] == ':')
+    {
+      colon = address + i - 1;
+      break;
+    }
+  }
+  if ((colon == NULL) || (colon == address) || ((size_t)(colon - address) >= sizeof(host)) ||
+      ((size_t)(address + len - colon - 1) == 0) || ((size_t)(address + len - colon - 1) >= sizeof(port)))
+  {
+    return 1;
+  }
+  for (i = 1; colon + i < address + len; i++)
+  {
+    if (!isdigit((unsigned char)colon[i]))
+    {
+      return 1;
+    }
+  }
+  memcpy(host, address, (size_t)(colon - address));
+  host[colon - address] = '\0';
+  memcpy(port, colon + 1, (size_t)(address + len - colon - 1));
+  port[address + len - colon - 1] = '\0';
+
+  LPA_TRACE_BEGIN("sim http exchange");
+  fd = sim_http_connect(host, port);
+  if (fd < 0)
+  {
+    LPA_TRACE_END("sim http exchange");
+    return -1;
+  }
+  body_len = (int)strlen("{\"euiccChallenge\":\"AAAAAAAAAAAAAAAAAAAAAA==\",\"smdpAddress\":\"\"}") + (int)len;
+  request_len = snprintf(request, sizeof(request),
+           "POST %s HTTP/1.1\r\nHost: %.*s\r\nUser-Agent: gsma-rsp-lpad\r\nX-Admin-Protocol: gsma/rsp/v2.2.0\r\n"
+           "Content-Type: application/json\r\nContent-Length: %d\r\nConnection: close\r\n\r\n"
+           "{\"euiccChallenge\":\"AAAAAAAAAAAAAAAAAAAAAA==\",\"smdpAddress\":\"%.*s\"}",
+           path, (int)len, address, body_len, (int)len, address);
+  /* a truncated body would leave the server waiting for bytes never sent */
+  if ((request_len < 0) || ((size_t)request_len >= sizeof(request)) ||
+      (sim_http_send(fd, request, (size_t)request_len) != 0))
+  {
+    close(fd);
+    LPA_TRACE_END("sim http exchange");
+    return -1;
+  }
+  /* the status line is kept, the rest of the answer is drained until the server closes */
+  for (;;)
+  {
+    got = recv(fd, response + used, sizeof(response) - 1 - used, 0);
+    if (got < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (got <= 0)
+    {
+      break;
+    }
+    if (used + (size_t)got < 64)
+    {
+      used += (size_t)got;
+    }
+    else if (used < 64)
+    {
+      used = 64;
+    }
+  }
+  close(fd);
+  LPA_TRACE_END("sim http exchange");
+  if (got < 0)
+  {
+    return -1;
+  }
+  response[used] = '\0';
+  if (sscanf(response, "HTTP/%*d.%*d %d", &status) != 1)
+  {
+    return -1;
+  }
+  return (status == 200) ? 0 : -1;
+}
 
 int cellular_esim_download_profile_with_activationcode(char* ActivationCodeStr, cellular_sim_download_progress_callback download_progress)
 {
-  /*TODO: Implement Me!*/
-  (void)ActivationCodeStr;
-  (void)download_progress;
-  return (int)0;
+  const char *smdp = NULL;
+  const char *end = NULL;
+  long step_us = 0;
+  int step = 0;
+
+  /* Activation code format is "1$<SM-DP+ address>$<matching id>" */
+  if ((ActivationCodeStr == NULL) || strncmp(ActivationCodeStr, "1$", 2))
+  {
+    return RETURN_ERROR;
+  }
+  smdp = ActivationCodeStr + 2;
+  end = strchr(smdp, '$');
+  if ((end == NULL) || !sim_address_valid(smdp, (size_t)(end - smdp)))
+  {
+    return RETURN_ERROR;
+  }
+  pthread_mutex_lock(&sim_lock);
+  if (!sim_initialized)
+  {
+    pthread_mutex_unlock(&sim_lock);
+    return RETURN_ERROR;
+  }
+  step_us = sim_latency_us[SIM_OP_DOWNLOAD] / SIM_DOWNLOAD_STEPS;
+  pthread_mutex_unlock(&sim_lock);
+
+  for (step = 0; step <= SIM_DOWNLOAD_STEPS; step++)
+  {
+    if (step > 0)
+    {
+      sim_sleep_us(step_us);
+    }
+    if (download_progress != NULL)
+    {
+      LPA_TRACE_BEGIN("download_progress");
+      download_progress((step * 100) / SIM_DOWNLOAD_STEPS);
+      LPA_TRACE_END("download_progress");
+    }
+    if ((step == 0) && (sim_remote_exchange(smdp, (size_t)(end - smdp), SIM_ES9_PATH) < 0))
+    {
+      return RETURN_ERROR;
+    }
+  }
+  return RETURN_OK;
+}
+
+static int sim_download_from(const char *address, const char *path)
+{
+  if ((address == NULL) || !sim_address_valid(address, strlen(address)))
+  {
+    return RETURN_ERROR;
+  }
+  sim_enter(SIM_OP_DOWNLOAD);
+  if (!sim_initialized)
+  {
+    sim_leave();
+    return RETURN_ERROR;
+  }
+  sim_leave();
+  return (sim_remote_exchange(address, strlen(address), path) < 0) ? RETURN_ERROR : RETURN_OK;
 }
 
 int cellular_esim_download_profile_from_smds(char* smds)
 {
-  /*TODO: Implement Me!*/
-  (void)smds;
-  return (int)0;
+  return sim_download_from(smds, SIM_ES11_PATH);
 }
 
 int cellular_esim_download_profile_from_defaultsmdp(char* smdp)
 {
-  /*TODO: Implement Me!*/
-  (void)smdp;
-  return (int)0;
+  return sim_download_from(smdp, SIM_ES9_PATH);
 }
 
 int cellular_esim_get_profile_info(eSIMProfileStruct** profile_list, int* nb_profiles)
 {
-  /*TODO: Implement Me!*/
-  (void)profile_list;
-  (void)nb_profiles;
-  return (int)0;
+  eSIMProfileStruct *list = NULL;
+  int i = 0;
+
+  if ((profile_list == NULL) || (nb_profiles == NULL))
+  {
+    return RETURN_ERROR;
+  }
+  sim_enter(SIM_OP_GET_PROFILE_INFO);
+  if (!sim_initialized)
+  {
+    sim_leave();
+    return RETURN_ERROR;
+  }
+  /* never hand back NULL on success, even when the eUICC is empty */
+  list = (eSIMProfileStruct *)calloc((size_t)(sim_nb_profiles > 0 ? sim_nb_profiles : 1), sizeof(eSIMProfileStruct));
+  if (list == NULL)
+  {
+    sim_leave();
+    return RETURN_ERROR;
+  }
+  for (i = 0; i < sim_nb_profiles; i++)
+  {
+    strncpy(list[i].iccid, sim_profiles[i].iccid, sizeof(list[i].iccid) - 1);
+    strncpy(list[i].profileName, sim_profiles[i].profileName, sizeof(list[i].profileName) - 1);
+    list[i].profileState = sim_profiles[i].profileState;
+  }
+  *nb_profiles = sim_nb_profiles;
+  *profile_list = list;
+  sim_leave();
+  return RETURN_OK;
 }
 
 int cellular_esim_enable_profile(char* iccid, int iccid_size)
 {
-  /*TODO: Implement Me!*/
-  (void)iccid;
-  (void)iccid_size;
-  return (int)0;
+  sim_profile_t *profile = NULL;
+  int i = 0;
+
+  if (!sim_iccid_valid(iccid, iccid_size))
+  {
+    return RETURN_ERROR;
+  }
+  sim_enter(SIM_OP_ENABLE);
+  profile = sim_initialized ? sim_find(iccid, iccid_size) : NULL;
+  if (profile == NULL)
+  {
+    sim_leave();
+    return RETURN_ERROR;
+  }
+  for (i = 0; i < sim_nb_profiles; i++)
+  {
+    sim_profiles[i].profileState = 0;
+  }
+  profile->profileState = 1;
+  sim_leave();
+  return RETURN_OK;
 }
 
 int cellular_esim_disable_profile(char* iccid, int iccid_size)
 {
-  /*TODO: Implement Me!*/
-  (void)iccid;
-  (void)iccid_size;
-  return (int)0;
+  sim_profile_t *profile = NULL;
+
+  if (!sim_iccid_valid(iccid, iccid_size))
+  {
+    return RETURN_ERROR;
+  }
+  sim_enter(SIM_OP_DISABLE);
+  profile = sim_initialized ? sim_find(iccid, iccid_size) : NULL;
+  if (profile == NULL)
+  {
+    sim_leave();
+    return RETURN_ERROR;
+  }
+  profile->profileState = 0;
+  sim_leave();
+  return RETURN_OK;
 }
 
 int cellular_esim_delete_profile(char* iccid, int iccid_size)
 {
-  /*TODO: Implement Me!*/
-  (void)iccid;
-  (void)iccid_size;
-  return (int)0;
+  sim_profile_t *profile = NULL;
+
+  if (!sim_iccid_valid(iccid, iccid_size))
+  {
+    return RETURN_ERROR;
+  }
+  sim_enter(SIM_OP_DELETE);
+  profile = sim_initialized ? sim_find(iccid, iccid_size) : NULL;
+  if ((profile == NULL) || (profile->profileState != 0))
+  {
+    sim_leave();
+    return RETURN_ERROR;
+  }
+  /* keep the table dense, order of the remaining profiles is preserved */
+  memmove(profile, profile + 1, (size_t)(&sim_profiles[sim_nb_profiles] - (profile + 1)) * sizeof(sim_profile_t));
+  sim_nb_profiles--;
+  sim_leave();
+  return RETURN_OK;
 }
 
 int cellular_esim_lpa_init(void)
 {
-  /*TODO: Implement Me!*/
-  return (int)0;
+  const char *seed = getenv("LPA_SIM_ICCIDS");
+  const char *config = getenv("LPA_SIM_CONFIG");
+  const char *serialize = getenv("LPA_SIM_SERIALIZE");
+  char *config_seed = NULL;
+  int ret = RETURN_OK;
+
+  if ((config != NULL) && (*config != '\0'))
+  {
+    config_seed = sim_read_config(config);
+    if (config_seed == NULL)
+    {
+      return RETURN_ERROR;
+    }
+    seed = config_seed;
+  }
+  if (seed == NULL)
+  {
+    seed = SIM_DEFAULT_ICCIDS;
+  }
+  pthread_mutex_lock(&sim_lock);
+  sim_parse_latency(getenv("LPA_SIM_LATENCY_US"));
+  sim_serialize = ((serialize == NULL) || strcmp(serialize, "0")) ? 1 : 0;
+  /* like a freshly powered eUICC, every init after an exit starts again from the seeded profiles */
+  if (!sim_initialized || (sim_seed == NULL) || strcmp(sim_seed, seed))
+  {
+    free(sim_seed);
+    sim_seed = strdup(seed);
+    if ((sim_seed == NULL) || (sim_seed_profiles(seed) != 0))
+    {
+      free(sim_seed);
+      sim_seed = NULL;
+      ret = RETURN_ERROR;
+    }
+  }
+  if (ret == RETURN_OK)
+  {
+    sim_sleep_us(sim_latency_us[SIM_OP_INIT]);
+    sim_initialized = 1;
+  }
+  pthread_mutex_unlock(&sim_lock);
+  free(config_seed);
+  return ret;
 }
 
 int cellular_esim_lpa_exit(void)
 {
-  /*TODO: Implement Me!*/
-  return (int)0;
+  sim_enter(SIM_OP_EXIT);
+  sim_initialized = 0;
+  sim_leave();
+  return RETURN_OK;
 }
 
 int cellular_esim_get_eid(void)
 {
-  /*TODO: Implement Me!*/
-  return (int)0;
+  int ret = RETURN_OK;
+
+  sim_enter(SIM_OP_GET_EID);
+  if (!sim_initialized)
+  {
+    ret = RETURN_ERROR;
+  }
+  sim_leave();
+  return ret;
 }
 
 int cellular_esim_get_euicc(void)
 {
-  /*TODO: Implement Me!*/
-  return (int)0;
-}
+  int ret = RETURN_OK;
 
+  sim_enter(SIM_OP_GET_EUICC);
+  if (!sim_initialized)
+  {
+    ret = RETURN_ERROR;
+  }
+  sim_leave();
+  return ret;
+}
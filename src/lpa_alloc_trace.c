@@ -0,0 +1,327 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifdef LPA_ALLOC_TRACE
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "lpa_alloc_trace.h"
+
+/* glibc entry points of the real allocator */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+typedef struct
+{
+    uintptr_t ptr;              /* 0 for an empty slot */
+    size_t size;
+    uint32_t call;              /* call that allocated the block */
+    int api;
+} trace_block_t;
+
+typedef struct
+{
+    uint64_t calls;
+    uint64_t allocs;
+    uint64_t bytes;
+    uint64_t peak;              /* highest live bytes within a single call */
+    uint64_t returned;          /* live when the call returned */
+    uint64_t caller_freed;      /* of the returned bytes, freed after the call */
+} trace_stats_t;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static trace_block_t trace_blocks[LPA_ALLOC_TRACE_SLOTS];
+static trace_stats_t trace_stats[LPA_API_MAX];
+static size_t trace_live = 0;
+static uint64_t trace_untracked = 0;
+static uint32_t trace_next_call = 0;
+
+/* HAL call in flight on this thread, only the outermost call is accounted */
+static __thread int trace_api = -1;
+static __thread int trace_depth = 0;
+static __thread uint32_t trace_call = 0;
+static __thread uint64_t trace_call_live = 0;
+static __thread uint64_t trace_call_peak = 0;
+
+static size_t trace_slot(uintptr_t ptr)
+{
+    uint64_t h = (uint64_t)ptr * 0x9e3779b97f4a7c15ULL;
+
+    return (size_t)(h >> 48) & (LPA_ALLOC_TRACE_SLOTS - 1);
+}
+
+/* Called with trace_lock held */
+static void trace_insert(uintptr_t ptr, size_t size, int api, uint32_t call)
+{
+    size_t i = trace_slot(ptr);
+
+    /* keep a free slot so a lookup always terminates */
+    if (trace_live >= LPA_ALLOC_TRACE_SLOTS - 1)
+    {
+        trace_untracked++;
+        return;
+    }
+    while (trace_blocks[i].ptr != 0)
+    {
+        i = (i + 1) & (LPA_ALLOC_TRACE_SLOTS - 1);
+    }
+    trace_blocks[i].ptr = ptr;
+    trace_blocks[i].size = size;
+    trace_blocks[i].api = api;
+    trace_blocks[i].call = call;
+    trace_live++;
+}
+
+/* Called with trace_lock held, linear probing deletion by backward shift */
+static int trace_remove(uintptr_t ptr, trace_block_t *removed)
+{
+    size_t i = trace_slot(ptr);
+    size_t j = 0;
+    size_t home = 0;
+
+    while (trace_blocks[i].ptr != ptr)
+    {
+        if (trace_blocks[i].ptr == 0)
+        {
+            return -1;
+        }
+        i = (i + 1) & (LPA_ALLOC_TRACE_SLOTS - 1);
+    }
+    *removed = trace_blocks[i];
+    trace_blocks[i].ptr = 0;
+    trace_live--;
+    j = i;
+    for (;;)
+    {
+        j = (j + 1) & (LPA_ALLOC_TRACE_SLOTS - 1);
+        if (trace_blocks[j].ptr == 0)
+        {
+            break;
+        }
+        home = trace_slot(trace_blocks[j].ptr);
+        /* move the entry back unless its home lies cyclically in (i, j] */
+        if ((i <= j) ? ((home <= i) || (home > j)) : ((home <= i) && (home > j)))
+        {
+            trace_blocks[i] = trace_blocks[j];
+            trace_blocks[j].ptr = 0;
+            i = j;
+        }
+    }
+    return 0;
+}
+
+static void trace_alloc(void *ptr, size_t size)
+{
+    if ((ptr == NULL) || (trace_api < 0))
+    {
+        return;
+    }
+    trace_call_live += size;
+    if (trace_call_live > trace_call_peak)
+    {
+        trace_call_peak = trace_call_live;
+    }
+    pthread_mutex_lock(&trace_lock);
+    trace_stats[trace_api].allocs++;
+    trace_stats[trace_api].bytes += size;
+    trace_insert((uintptr_t)ptr, size, trace_api, trace_call);
+    pthread_mutex_unlock(&trace_lock);
+}
+
+static void trace_free(void *ptr)
+{
+    trace_block_t block;
+
+    /* unlocked read: an untracked free only needs to see its own thread's inserts */
+    if ((ptr == NULL) || (trace_live == 0))
+    {
+        return;
+    }
+    pthread_mutex_lock(&trace_lock);
+    if (trace_remove((uintptr_t)ptr, &block) == 0)
+    {
+        if ((trace_api >= 0) && (block.call == trace_call))
+        {
+            trace_call_live -= block.size;
+        }
+        else
+        {
+            trace_stats[block.api].caller_freed += block.size;
+        }
+    }
+    pthread_mutex_unlock(&trace_lock);
+}
+
+void lpa_alloc_trace_begin(lpa_api_t api)
+{
+    if (trace_depth++ > 0)
+    {
+        return;
+    }
+    trace_call_live = 0;
+    trace_call_peak = 0;
+    pthread_mutex_lock(&trace_lock);
+    trace_stats[api].calls++;
+    trace_call = ++trace_next_call;
+    pthread_mutex_unlock(&trace_lock);
+    trace_api = (int)api;
+}
+
+void lpa_alloc_trace_end(lpa_api_t api)
+{
+    if (--trace_depth > 0)
+    {
+        return;
+    }
+    trace_api = -1;
+    pthread_mutex_lock(&trace_lock);
+    trace_stats[api].returned += trace_call_live;
+    if (trace_call_peak > trace_stats[api].peak)
+    {
+        trace_stats[api].peak = trace_call_peak;
+    }
+    pthread_mutex_unlock(&trace_lock);
+}
+
+void lpa_alloc_trace_report(void)
+{
+    uint64_t leaked_bytes[LPA_API_MAX];
+    uint64_t leaked_blocks[LPA_API_MAX];
+    trace_stats_t stats[LPA_API_MAX];
+    uint64_t untracked = 0;
+    size_t i = 0;
+    int api = 0;
+
+    memset(leaked_bytes, 0, sizeof(leaked_bytes));
+    memset(leaked_blocks, 0, sizeof(leaked_blocks));
+    pthread_mutex_lock(&trace_lock);
+    for (i = 0; i < LPA_ALLOC_TRACE_SLOTS; i++)
+    {
+        if (trace_blocks[i].ptr != 0)
+        {
+            leaked_bytes[trace_blocks[i].api] += trace_blocks[i].size;
+            leaked_blocks[trace_blocks[i].api]++;
+        }
+    }
+    memcpy(stats, trace_stats, sizeof(stats));
+    untracked = trace_untracked;
+    pthread_mutex_unlock(&trace_lock);
+
+    UT_LOG("heap usage per HAL API (bytes, per call figures are means)");
+    UT_LOG("%-52s %8s %12s %12s %10s %10s %12s %10s %8s", "api", "calls", "allocs/call", "bytes/call",
+           "peak", "returned", "caller freed", "leaked", "blocks");
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        if (stats[api].calls == 0)
+        {
+            continue;
+        }
+        UT_LOG("%-52s %8llu %12.1f %12.1f %10llu %10llu %12llu %10llu %8llu", lpa_api_name[api],
+               (unsigned long long)stats[api].calls,
+               (double)stats[api].allocs / (double)stats[api].calls,
+               (double)stats[api].bytes / (double)stats[api].calls,
+               (unsigned long long)stats[api].peak,
+               (unsigned long long)stats[api].returned,
+               (unsigned long long)stats[api].caller_freed,
+               (unsigned long long)leaked_bytes[api],
+               (unsigned long long)leaked_blocks[api]);
+    }
+    if (untracked > 0)
+    {
+        UT_LOG("%llu allocations were not tracked, the table of %d live blocks was full", (unsigned long long)untracked, LPA_ALLOC_TRACE_SLOTS);
+    }
+}
+
+/* Interposed allocator, exported by the test binary so shared libraries use it as well */
+
+void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+
+    trace_alloc(ptr, size);
+    return ptr;
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    void *ptr = __libc_calloc(nmemb, size);
+
+    trace_alloc(ptr, nmemb * size);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    void *moved = NULL;
+
+    trace_free(ptr);
+    moved = __libc_realloc(ptr, size);
+    if ((moved == NULL) && (size != 0))
+    {
+        /* the old block is still valid, it is no longer accounted */
+        return NULL;
+    }
+    trace_alloc(moved, size);
+    return moved;
+}
+
+void free(void *ptr)
+{
+    trace_free(ptr);
+    __libc_free(ptr);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+
+    trace_alloc(ptr, size);
+    return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    void *ptr = NULL;
+
+    if ((alignment < sizeof(void *)) || ((alignment & (alignment - 1)) != 0))
+    {
+        return EINVAL;
+    }
+    ptr = memalign(alignment, size);
+    if (ptr == NULL)
+    {
+        return ENOMEM;
+    }
+    *memptr = ptr;
+    return 0;
+}
+
+#endif /* LPA_ALLOC_TRACE */
@@ -0,0 +1,49 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_alloc_trace.h
+*
+* Heap accounting per HAL API, built with `make ALLOC_TRACE=1` (glibc only).
+*
+* malloc, calloc, realloc, free and the aligned allocators are interposed by the test binary, so
+* they also catch the allocations of a vendor shared library. A block allocated while a HAL call is
+* in flight on the same thread is attributed to that API and remembered until it is freed:
+* - bytes allocated per call and the peak of live bytes within one call
+* - bytes still live when the call returns, handed to the caller like the get_profile_info list
+* - how much of that the caller freed afterwards
+* - what is still live when the report is printed, i.e. leaked
+*/
+
+#ifndef LPA_ALLOC_TRACE_H
+#define LPA_ALLOC_TRACE_H
+
+#include "lpa_hal_wrap.h"
+
+/* Blocks that can be tracked at the same time, the excess is counted as untracked */
+#define LPA_ALLOC_TRACE_SLOTS  (1 << 16)
+
+void lpa_alloc_trace_begin(lpa_api_t api);
+void lpa_alloc_trace_end(lpa_api_t api);
+
+/**
+ * @brief Print the per API table through UT_LOG
+ */
+void lpa_alloc_trace_report(void);
+
+#endif /* LPA_ALLOC_TRACE_H */
@@ -0,0 +1,127 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "lpa_arena.h"
+
+#define ARENA_ALIGN  (sizeof(max_align_t))
+
+struct lpa_arena_chunk
+{
+    lpa_arena_chunk_t *next;
+    size_t size;
+    size_t used;
+    max_align_t data[];
+};
+
+static size_t arena_round(size_t size)
+{
+    return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+void lpa_arena_init(lpa_arena_t *arena, size_t chunk_size)
+{
+    arena->head = NULL;
+    arena->chunk_size = (chunk_size == 0) ? LPA_ARENA_DEFAULT_CHUNK : arena_round(chunk_size);
+    arena->allocated = 0;
+}
+
+void *lpa_arena_alloc(lpa_arena_t *arena, size_t size)
+{
+    lpa_arena_chunk_t *chunk = arena->head;
+    size_t rounded = arena_round((size == 0) ? 1 : size);
+    size_t chunk_size = 0;
+    void *block = NULL;
+
+    if (rounded < size)
+    {
+        return NULL;
+    }
+    if ((chunk == NULL) || (chunk->size - chunk->used < rounded))
+    {
+        chunk_size = (rounded > arena->chunk_size) ? rounded : arena->chunk_size;
+        chunk = (lpa_arena_chunk_t *)malloc(sizeof(lpa_arena_chunk_t) + chunk_size);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        if ((arena->head != NULL) && (rounded > arena->chunk_size))
+        {
+            /* oversized block: keep filling the current chunk afterwards */
+            chunk->next = arena->head->next;
+            arena->head->next = chunk;
+        }
+        else
+        {
+            chunk->next = arena->head;
+            arena->head = chunk;
+        }
+    }
+    block = (char *)chunk->data + chunk->used;
+    chunk->used += rounded;
+    arena->allocated += rounded;
+    return block;
+}
+
+char *lpa_arena_strndup(lpa_arena_t *arena, const char *text, size_t len)
+{
+    char *copy = (char *)lpa_arena_alloc(arena, len + 1);
+
+    if (copy != NULL)
+    {
+        memcpy(copy, text, len);
+        copy[len] = '\0';
+    }
+    return copy;
+}
+
+void lpa_arena_reset(lpa_arena_t *arena)
+{
+    lpa_arena_chunk_t *chunk = NULL;
+    lpa_arena_chunk_t *next = NULL;
+
+    if (arena->head == NULL)
+    {
+        return;
+    }
+    for (chunk = arena->head->next; chunk != NULL; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+    arena->head->next = NULL;
+    arena->head->used = 0;
+    arena->allocated = 0;
+    /* do not keep an oversized chunk alive between uses */
+    if (arena->head->size > arena->chunk_size)
+    {
+        free(arena->head);
+        arena->head = NULL;
+    }
+}
+
+void lpa_arena_destroy(lpa_arena_t *arena)
+{
+    lpa_arena_reset(arena);
+    free(arena->head);
+    arena->head = NULL;
+}
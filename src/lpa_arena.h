@@ -0,0 +1,77 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_arena.h
+*
+* Bump allocator for the test harness.
+*
+* Memory is carved out of large chunks and never freed one block at a time: the whole arena is
+* released by lpa_arena_destroy(), or rewound by lpa_arena_reset() which keeps one chunk for
+* the next use. Meant for data with a common lifetime (the lpa_config tables, per-test scratch
+* buffers) so long repeated runs do not fragment the heap. Not thread safe.
+*/
+
+#ifndef LPA_ARENA_H
+#define LPA_ARENA_H
+
+#include <stddef.h>
+
+#define LPA_ARENA_DEFAULT_CHUNK  (64 * 1024)
+
+typedef struct lpa_arena_chunk lpa_arena_chunk_t;
+
+typedef struct
+{
+    lpa_arena_chunk_t *head;    /* chunk being filled, older chunks follow */
+    size_t chunk_size;
+    size_t allocated;           /* bytes handed out since the last reset */
+} lpa_arena_t;
+
+/**
+ * @brief Prepare an empty arena, no memory is taken until the first allocation
+ *
+ * @param chunk_size size of the chunks requested from malloc, 0 for LPA_ARENA_DEFAULT_CHUNK
+ */
+void lpa_arena_init(lpa_arena_t *arena, size_t chunk_size);
+
+/**
+ * @brief Allocate `size` bytes aligned for any type
+ *
+ * Requests larger than the chunk size get a chunk of their own.
+ *
+ * @return NULL when malloc fails
+ */
+void *lpa_arena_alloc(lpa_arena_t *arena, size_t size);
+
+/**
+ * @brief Copy `len` bytes of `text` followed by a NUL into the arena
+ */
+char *lpa_arena_strndup(lpa_arena_t *arena, const char *text, size_t len);
+
+/**
+ * @brief Forget every allocation, keeping the current chunk for reuse
+ */
+void lpa_arena_reset(lpa_arena_t *arena);
+
+/**
+ * @brief Release all the chunks, the arena can be used again afterwards
+ */
+void lpa_arena_destroy(lpa_arena_t *arena);
+
+#endif /* LPA_ARENA_H */
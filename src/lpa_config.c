@@ -0,0 +1,410 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lpa_config.h"
+
+typedef struct
+{
+    char *cur;
+    char *end;
+} config_cursor_t;
+
+lpa_config_status_t lpa_config_open(lpa_config_t *cfg, const char *path)
+{
+    struct stat st;
+    void *map = NULL;
+    int fd = -1;
+
+    cfg->data = NULL;
+    cfg->size = 0;
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return LPA_CONFIG_ERR_OPEN;
+    }
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return LPA_CONFIG_ERR_OPEN;
+    }
+    if (st.st_size == 0)
+    {
+        close(fd);
+        return LPA_CONFIG_ERR_EMPTY;
+    }
+    /* private writable mapping: the in place decoding never reaches the file */
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return LPA_CONFIG_ERR_OPEN;
+    }
+    cfg->data = (char *)map;
+    cfg->size = (size_t)st.st_size;
+    return LPA_CONFIG_OK;
+}
+
+void lpa_config_close(lpa_config_t *cfg)
+{
+    if (cfg->data != NULL)
+    {
+        munmap(cfg->data, cfg->size);
+    }
+    cfg->data = NULL;
+    cfg->size = 0;
+}
+
+static void config_skip_ws(config_cursor_t *c)
+{
+    while ((c->cur < c->end) && ((*c->cur == ' ') || (*c->cur == '\t') || (*c->cur == '\n') || (*c->cur == '\r')))
+    {
+        c->cur++;
+    }
+}
+
+static int config_hex4(const char *p, unsigned int *out)
+{
+    unsigned int value = 0;
+    int i = 0;
+
+    for (i = 0; i < 4; i++)
+    {
+        char ch = p[i];
+
+        value <<= 4;
+        if ((ch >= '0') && (ch <= '9'))
+        {
+            value |= (unsigned int)(ch - '0');
+        }
+        else if ((ch >= 'a') && (ch <= 'f'))
+        {
+            value |= (unsigned int)(ch - 'a' + 10);
+        }
+        else if ((ch >= 'A') && (ch <= 'F'))
+        {
+            value |= (unsigned int)(ch - 'A' + 10);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    *out = value;
+    return 0;
+}
+
+/**
+ * Decodes the string starting at the opening quote in place. The decoded text never grows,
+ * so it is written over the encoded one and terminated where the closing quote was.
+ */
+static int config_string(config_cursor_t *c, lpa_strview_t *view)
+{
+    char *out = NULL;
+    char *start = NULL;
+
+    if ((c->cur >= c->end) || (*c->cur != '"'))
+    {
+        return -1;
+    }
+    start = out = ++c->cur;
+    while (c->cur < c->end)
+    {
+        char ch = *c->cur++;
+
+        if (ch == '"')
+        {
+            *out = '\0';
+            view->ptr = start;
+            view->len = (size_t)(out - start);
+            return 0;
+        }
+        if ((unsigned char)ch < 0x20)
+        {
+            return -1;
+        }
+        if (ch != '\\')
+        {
+            *out++ = ch;
+            continue;
+        }
+        if (c->cur >= c->end)
+        {
+            return -1;
+        }
+        ch = *c->cur++;
+        switch (ch)
+        {
+            case '"': case '\\': case '/':
+                *out++ = ch;
+                break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u':
+            {
+                unsigned int cp = 0;
+
+                if ((c->end - c->cur < 4) || (config_hex4(c->cur, &cp) != 0))
+                {
+                    return -1;
+                }
+                c->cur += 4;
+                /* UTF-8 encode, 3 bytes at most for the 6 consumed */
+                if (cp < 0x80)
+                {
+                    *out++ = (char)cp;
+                }
+                else if (cp < 0x800)
+                {
+                    *out++ = (char)(0xc0 | (cp >> 6));
+                    *out++ = (char)(0x80 | (cp & 0x3f));
+                }
+                else
+                {
+                    *out++ = (char)(0xe0 | (cp >> 12));
+                    *out++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+                    *out++ = (char)(0x80 | (cp & 0x3f));
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return -1;
+}
+
+static int config_skip_value(config_cursor_t *c, int depth);
+
+static int config_skip_container(config_cursor_t *c, char close, int depth)
+{
+    lpa_strview_t ignored;
+
+    c->cur++;
+    config_skip_ws(c);
+    if ((c->cur < c->end) && (*c->cur == close))
+    {
+        c->cur++;
+        return 0;
+    }
+    while (c->cur < c->end)
+    {
+        if (close == '}')
+        {
+            if (config_string(c, &ignored) != 0)
+            {
+                return -1;
+            }
+            config_skip_ws(c);
+            if ((c->cur >= c->end) || (*c->cur != ':'))
+            {
+                return -1;
+            }
+            c->cur++;
+        }
+        if (config_skip_value(c, depth + 1) != 0)
+        {
+            return -1;
+        }
+        config_skip_ws(c);
+        if (c->cur >= c->end)
+        {
+            return -1;
+        }
+        if (*c->cur == close)
+        {
+            c->cur++;
+            return 0;
+        }
+        if (*c->cur != ',')
+        {
+            return -1;
+        }
+        c->cur++;
+        config_skip_ws(c);
+    }
+    return -1;
+}
+
+/* Skips any json value, nesting is bounded so a hostile file cannot exhaust the stack */
+static int config_skip_value(config_cursor_t *c, int depth)
+{
+    lpa_strview_t ignored;
+    char *start = NULL;
+
+    config_skip_ws(c);
+    if ((c->cur >= c->end) || (depth > 32))
+    {
+        return -1;
+    }
+    switch (*c->cur)
+    {
+        case '"':
+            return config_string(c, &ignored);
+        case '{':
+            return config_skip_container(c, '}', depth);
+        case '[':
+            return config_skip_container(c, ']', depth);
+        default:
+            /* number, true, false or null */
+            start = c->cur;
+            while ((c->cur < c->end) && (strchr("+-.0123456789eEtruefalsn", *c->cur) != NULL))
+            {
+                c->cur++;
+            }
+            return (c->cur > start) ? 0 : -1;
+    }
+}
+
+/* Top level member value: strings and arrays of strings are reported, anything else is skipped */
+static lpa_config_status_t config_member(config_cursor_t *c, lpa_strview_t key, lpa_config_string_cb cb, void *ctx)
+{
+    lpa_strview_t value;
+    int index = 0;
+
+    config_skip_ws(c);
+    if (c->cur >= c->end)
+    {
+        return LPA_CONFIG_ERR_SYNTAX;
+    }
+    if (*c->cur == '"')
+    {
+        if (config_string(c, &value) != 0)
+        {
+            return LPA_CONFIG_ERR_SYNTAX;
+        }
+        return (cb(ctx, key, -1, value) == 0) ? LPA_CONFIG_OK : LPA_CONFIG_ERR_ABORTED;
+    }
+    if (*c->cur != '[')
+    {
+        return (config_skip_value(c, 1) == 0) ? LPA_CONFIG_OK : LPA_CONFIG_ERR_SYNTAX;
+    }
+    c->cur++;
+    config_skip_ws(c);
+    if ((c->cur < c->end) && (*c->cur == ']'))
+    {
+        c->cur++;
+        return LPA_CONFIG_OK;
+    }
+    while (c->cur < c->end)
+    {
+        config_skip_ws(c);
+        if ((c->cur < c->end) && (*c->cur == '"'))
+        {
+            if (config_string(c, &value) != 0)
+            {
+                return LPA_CONFIG_ERR_SYNTAX;
+            }
+            if (cb(ctx, key, index, value) != 0)
+            {
+                return LPA_CONFIG_ERR_ABORTED;
+            }
+        }
+        else if (config_skip_value(c, 2) != 0)
+        {
+            return LPA_CONFIG_ERR_SYNTAX;
+        }
+        index++;
+        config_skip_ws(c);
+        if (c->cur >= c->end)
+        {
+            break;
+        }
+        if (*c->cur == ']')
+        {
+            c->cur++;
+            return LPA_CONFIG_OK;
+        }
+        if (*c->cur != ',')
+        {
+            break;
+        }
+        c->cur++;
+    }
+    return LPA_CONFIG_ERR_SYNTAX;
+}
+
+lpa_config_status_t lpa_config_parse(lpa_config_t *cfg, lpa_config_string_cb cb, void *ctx)
+{
+    config_cursor_t c;
+    lpa_config_status_t status = LPA_CONFIG_OK;
+    lpa_strview_t key;
+
+    if (cfg->data == NULL)
+    {
+        return LPA_CONFIG_ERR_OPEN;
+    }
+    c.cur = cfg->data;
+    c.end = cfg->data + cfg->size;
+    config_skip_ws(&c);
+    if (c.cur >= c.end)
+    {
+        return LPA_CONFIG_ERR_EMPTY;
+    }
+    if (*c.cur != '{')
+    {
+        return LPA_CONFIG_ERR_SYNTAX;
+    }
+    c.cur++;
+    config_skip_ws(&c);
+    if ((c.cur < c.end) && (*c.cur == '}'))
+    {
+        return LPA_CONFIG_OK;
+    }
+    while (c.cur < c.end)
+    {
+        config_skip_ws(&c);
+        if (config_string(&c, &key) != 0)
+        {
+            return LPA_CONFIG_ERR_SYNTAX;
+        }
+        config_skip_ws(&c);
+        if ((c.cur >= c.end) || (*c.cur != ':'))
+        {
+            return LPA_CONFIG_ERR_SYNTAX;
+        }
+        c.cur++;
+        status = config_member(&c, key, cb, ctx);
+        if (status != LPA_CONFIG_OK)
+        {
+            return status;
+        }
+        config_skip_ws(&c);
+        if (c.cur >= c.end)
+        {
+            break;
+        }
+        if (*c.cur == '}')
+        {
+            return LPA_CONFIG_OK;
+        }
+        if (*c.cur != ',')
+        {
+            break;
+        }
+        c.cur++;
+    }
+    return LPA_CONFIG_ERR_SYNTAX;
+}
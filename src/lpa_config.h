@@ -0,0 +1,77 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_config.h
+*
+* In-situ loader for the lpa_config json file.
+*
+* The file is mapped copy-on-write and parsed in a single pass without any allocation: escape
+* sequences are decoded in place and every string value is NUL terminated where its closing
+* quote was. Values are handed out as views into the mapping, which stay valid until
+* lpa_config_close().
+*
+* Only what lpa_config needs is reported: string members of the top level object and the
+* string elements of top level arrays. Other values are syntax checked and skipped.
+*/
+
+#ifndef LPA_CONFIG_H
+#define LPA_CONFIG_H
+
+#include <stddef.h>
+
+typedef struct
+{
+    const char *ptr;    /* NUL terminated, inside the mapping */
+    size_t len;
+} lpa_strview_t;
+
+typedef struct
+{
+    char *data;
+    size_t size;
+} lpa_config_t;
+
+typedef enum
+{
+    LPA_CONFIG_OK = 0,
+    LPA_CONFIG_ERR_OPEN = -1,
+    LPA_CONFIG_ERR_EMPTY = -2,
+    LPA_CONFIG_ERR_SYNTAX = -3,
+    LPA_CONFIG_ERR_ABORTED = -4
+} lpa_config_status_t;
+
+/**
+ * @brief Called for every string found, `index` is the array position or -1 for a plain string member
+ *
+ * @return 0 to continue parsing, anything else aborts with LPA_CONFIG_ERR_ABORTED
+ */
+typedef int (*lpa_config_string_cb)(void *ctx, lpa_strview_t key, int index, lpa_strview_t value);
+
+lpa_config_status_t lpa_config_open(lpa_config_t *cfg, const char *path);
+
+/**
+ * @brief Parse the mapped file once, calling `cb` for every string value
+ *
+ * Must be called at most once per lpa_config_open(), the text is rewritten in place.
+ */
+lpa_config_status_t lpa_config_parse(lpa_config_t *cfg, lpa_config_string_cb cb, void *ctx);
+
+void lpa_config_close(lpa_config_t *cfg);
+
+#endif /* LPA_CONFIG_H */
@@ -0,0 +1,265 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lpa_config_cache.h"
+
+/* FNV-1a, 64 bit */
+static uint64_t cache_hash(const char *data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static size_t cache_file_size(const lpa_config_cache_header_t *header)
+{
+    return (size_t)header->header_size + (size_t)header->nb_iccid * header->iccid_width +
+           (size_t)header->nb_profile_name * header->name_width;
+}
+
+/* Layout checks, then every slot must end with its padding NUL */
+static int cache_valid(const lpa_config_cache_t *cache)
+{
+    const lpa_config_cache_header_t *header = cache->header;
+    uint32_t i = 0;
+
+    if ((cache->size < sizeof(lpa_config_cache_header_t)) ||
+        (memcmp(header->magic, LPA_CONFIG_CACHE_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != LPA_CONFIG_CACHE_VERSION) ||
+        (header->header_size != sizeof(lpa_config_cache_header_t)) ||
+        (header->iccid_width != LPA_CONFIG_CACHE_ICCID_WIDTH) ||
+        (header->name_width != LPA_CONFIG_CACHE_NAME_WIDTH) ||
+        (cache_file_size(header) != cache->size))
+    {
+        return 0;
+    }
+    for (i = 0; i < header->nb_iccid; i++)
+    {
+        if (lpa_config_cache_iccid(cache, i)[header->iccid_width - 1] != '\0')
+        {
+            return 0;
+        }
+    }
+    for (i = 0; i < header->nb_profile_name; i++)
+    {
+        if (lpa_config_cache_name(cache, i)[header->name_width - 1] != '\0')
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+const char *lpa_config_cache_path(void)
+{
+    const char *path = getenv("LPA_CONFIG_CACHE");
+
+    if ((path == NULL) || (*path == '\0'))
+    {
+        return LPA_CONFIG_CACHE_DEFAULT;
+    }
+    return (strcmp(path, "none") == 0) ? NULL : path;
+}
+
+lpa_config_status_t lpa_config_cache_source(const char *config_path, lpa_config_source_t *source)
+{
+    struct stat st;
+
+    memset(source, 0, sizeof(*source));
+    if (stat(config_path, &st) != 0)
+    {
+        return LPA_CONFIG_ERR_OPEN;
+    }
+    if (st.st_size == 0)
+    {
+        return LPA_CONFIG_ERR_EMPTY;
+    }
+    source->size = (uint64_t)st.st_size;
+    source->mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    return LPA_CONFIG_OK;
+}
+
+int lpa_config_cache_open(lpa_config_cache_t *cache, const char *path, lpa_config_source_t *source, const lpa_config_t *text)
+{
+    const lpa_config_cache_header_t *header = NULL;
+    struct stat st;
+    void *map = NULL;
+    int fd = -1;
+
+    cache->header = NULL;
+    cache->size = 0;
+    if ((text != NULL) && !source->hashed)
+    {
+        source->hash = cache_hash(text->data, text->size);
+        source->hashed = 1;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(lpa_config_cache_header_t)))
+    {
+        close(fd);
+        return -1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return -1;
+    }
+    cache->header = header = (const lpa_config_cache_header_t *)map;
+    cache->size = (size_t)st.st_size;
+    if (!cache_valid(cache) || (header->source_size != source->size))
+    {
+        lpa_config_cache_close(cache);
+        return -1;
+    }
+    if (header->source_mtime_ns == source->mtime_ns)
+    {
+        return 0;
+    }
+    if (!source->hashed || (header->source_hash != source->hash))
+    {
+        lpa_config_cache_close(cache);
+        return -1;
+    }
+    /* same content under a new mtime, record it so the next start takes the fast path */
+    fd = open(path, O_WRONLY);
+    if (fd >= 0)
+    {
+        if (pwrite(fd, &source->mtime_ns, sizeof(source->mtime_ns),
+                   (off_t)offsetof(lpa_config_cache_header_t, source_mtime_ns)) != (ssize_t)sizeof(source->mtime_ns))
+        {
+            printf("Unable to refresh %s\n", path);
+        }
+        close(fd);
+    }
+    return 0;
+}
+
+int lpa_config_cache_write(const char *path, const lpa_config_source_t *source, char **iccids, int nb_iccids,
+                           char **names, int nb_names)
+{
+    lpa_config_cache_header_t header;
+    char temp[4096];
+    char *data = NULL;
+    char *slot = NULL;
+    size_t size = 0;
+    size_t written = 0;
+    ssize_t chunk = 0;
+    int fd = -1;
+    int i = 0;
+
+    if (!source->hashed)
+    {
+        return -1;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LPA_CONFIG_CACHE_MAGIC, sizeof(header.magic));
+    header.version = LPA_CONFIG_CACHE_VERSION;
+    header.header_size = (uint32_t)sizeof(header);
+    header.source_size = source->size;
+    header.source_mtime_ns = source->mtime_ns;
+    header.source_hash = source->hash;
+    header.nb_iccid = (uint32_t)nb_iccids;
+    header.nb_profile_name = (uint32_t)nb_names;
+    header.iccid_width = LPA_CONFIG_CACHE_ICCID_WIDTH;
+    header.name_width = LPA_CONFIG_CACHE_NAME_WIDTH;
+    size = cache_file_size(&header);
+
+    /* calloc: the padding of every slot is NUL */
+    data = (char *)calloc(1, size);
+    if (data == NULL)
+    {
+        return -1;
+    }
+    memcpy(data, &header, sizeof(header));
+    slot = data + header.header_size;
+    for (i = 0; i < nb_iccids; i++, slot += LPA_CONFIG_CACHE_ICCID_WIDTH)
+    {
+        if (strlen(iccids[i]) >= LPA_CONFIG_CACHE_ICCID_WIDTH)
+        {
+            free(data);
+            return -1;
+        }
+        strcpy(slot, iccids[i]);
+    }
+    for (i = 0; i < nb_names; i++, slot += LPA_CONFIG_CACHE_NAME_WIDTH)
+    {
+        if (strlen(names[i]) >= LPA_CONFIG_CACHE_NAME_WIDTH)
+        {
+            free(data);
+            return -1;
+        }
+        strcpy(slot, names[i]);
+    }
+
+    /* written next to the target then renamed, a concurrent start never maps a partial cache */
+    if ((size_t)snprintf(temp, sizeof(temp), "%s.%d.tmp", path, (int)getpid()) >= sizeof(temp))
+    {
+        free(data);
+        return -1;
+    }
+    fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        free(data);
+        return -1;
+    }
+    while (written < size)
+    {
+        chunk = write(fd, data + written, size - written);
+        if (chunk <= 0)
+        {
+            break;
+        }
+        written += (size_t)chunk;
+    }
+    free(data);
+    if ((close(fd) != 0) || (written != size) || (rename(temp, path) != 0))
+    {
+        unlink(temp);
+        return -1;
+    }
+    return 0;
+}
+
+void lpa_config_cache_close(lpa_config_cache_t *cache)
+{
+    if (cache->header != NULL)
+    {
+        munmap((void *)cache->header, cache->size);
+    }
+    cache->header = NULL;
+    cache->size = 0;
+}
@@ -0,0 +1,130 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_config_cache.h
+*
+* Compiled form of lpa_config, mapped copy-on-write instead of parsing the json on every start.
+*
+* The cache file is the header below followed by two packed tables of NUL padded fixed-width
+* slots: the iccids, LPA_CONFIG_CACHE_ICCID_WIDTH bytes each, then the profile names,
+* LPA_CONFIG_CACHE_NAME_WIDTH bytes each. It is written in the native byte order; a cache from
+* another host fails the version check and is compiled again.
+*
+* A cache is current when it records the size and mtime of lpa_config. When only the mtime differs
+* (the file was copied or touched), the FNV-1a hash of the text decides and a match records the new
+* mtime, so the json is compiled again only when its content changed. A config holding a string too
+* long for its slot is not cached and keeps being parsed.
+*
+* - LPA_CONFIG_CACHE : cache file, default lpa_config.cache in the working directory, "none" to
+*   always parse lpa_config
+*/
+
+#ifndef LPA_CONFIG_CACHE_H
+#define LPA_CONFIG_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpa_config.h"
+#include "lpa_iccid.h"
+
+#define LPA_CONFIG_CACHE_MAGIC        "LPACACHE"
+#define LPA_CONFIG_CACHE_VERSION      1
+#define LPA_CONFIG_CACHE_DEFAULT      "lpa_config.cache"
+#define LPA_CONFIG_CACHE_ICCID_WIDTH  LPA_ICCID_SLOT
+/* profileName[65] of eSIMProfileStruct, rounded up to 8 */
+#define LPA_CONFIG_CACHE_NAME_WIDTH   72
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+    uint64_t source_hash;
+    uint32_t nb_iccid;
+    uint32_t nb_profile_name;
+    uint32_t iccid_width;
+    uint32_t name_width;
+} lpa_config_cache_header_t;
+
+/* Identity of the lpa_config the cache is checked against */
+typedef struct
+{
+    uint64_t size;
+    int64_t mtime_ns;
+    uint64_t hash;
+    int hashed;
+} lpa_config_source_t;
+
+typedef struct
+{
+    const lpa_config_cache_header_t *header;
+    size_t size;
+} lpa_config_cache_t;
+
+/**
+ * @brief The cache file named by LPA_CONFIG_CACHE, NULL when caching is disabled
+ */
+const char *lpa_config_cache_path(void);
+
+/**
+ * @brief Size and mtime of lpa_config, without reading it
+ *
+ * @return LPA_CONFIG_OK, LPA_CONFIG_ERR_OPEN or LPA_CONFIG_ERR_EMPTY like lpa_config_open()
+ */
+lpa_config_status_t lpa_config_cache_source(const char *config_path, lpa_config_source_t *source);
+
+/**
+ * @brief Map the cache if it was compiled from this lpa_config
+ *
+ * The mapping is private and writable, the slots may be handed to APIs taking a char * and the
+ * file is never modified through it.
+ *
+ * Without `text` only the recorded size and mtime are compared. With the unparsed mapping of
+ * lpa_config, its hash is stored in `source` and an mtime mismatch is settled by the hash.
+ *
+ * @return 0 when mapped, -1 when the cache is missing, invalid or stale
+ */
+int lpa_config_cache_open(lpa_config_cache_t *cache, const char *path, lpa_config_source_t *source, const lpa_config_t *text);
+
+/**
+ * @brief Compile the tables into the cache file, replaced atomically
+ *
+ * `source` must carry the hash of the text the tables were parsed from.
+ *
+ * @return 0, -1 when a string does not fit its slot or the file cannot be written
+ */
+int lpa_config_cache_write(const char *path, const lpa_config_source_t *source, char **iccids, int nb_iccids,
+                           char **names, int nb_names);
+
+void lpa_config_cache_close(lpa_config_cache_t *cache);
+
+static inline const char *lpa_config_cache_iccid(const lpa_config_cache_t *cache, uint32_t index)
+{
+    return (const char *)cache->header + cache->header->header_size + (size_t)index * cache->header->iccid_width;
+}
+
+static inline const char *lpa_config_cache_name(const lpa_config_cache_t *cache, uint32_t index)
+{
+    return (const char *)cache->header + cache->header->header_size +
+           (size_t)cache->header->nb_iccid * cache->header->iccid_width + (size_t)index * cache->header->name_width;
+}
+
+#endif /* LPA_CONFIG_CACHE_H */
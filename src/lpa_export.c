@@ -0,0 +1,258 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifdef LPA_HAL_WRAP
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "lpa_hal.h"
+#include "lpa_export.h"
+#include "lpa_perf.h"
+
+#define EXPORT_LINE_MAX  256
+
+static pthread_once_t export_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t export_lock = PTHREAD_MUTEX_INITIALIZER;
+static int export_enabled = 0;
+static int export_json = 0;
+static FILE *export_file = NULL;
+static uint64_t export_seq = 0;
+static lpa_hist_t export_hist[LPA_API_MAX];
+static int export_errors[LPA_API_MAX];
+
+static const char *export_env(const char *name)
+{
+    const char *value = getenv(name);
+
+    return ((value != NULL) && (*value != '\0')) ? value : NULL;
+}
+
+static void export_init(void)
+{
+    const char *path = export_env("LPA_EXPORT");
+    size_t len = 0;
+    int api = 0;
+
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        lpa_hist_reset(&export_hist[api]);
+    }
+    if (path != NULL)
+    {
+        export_file = fopen(path, "w");
+        if (export_file == NULL)
+        {
+            UT_LOG("LPA_EXPORT : unable to create %s", path);
+        }
+        else
+        {
+            len = strlen(path);
+            export_json = (len >= 5) && (strcmp(path + len - 5, ".json") == 0);
+            fputs(export_json ? "[\n" : "seq,api,args,result,timeout,wall_ns,cpu_ns\n", export_file);
+        }
+    }
+    export_enabled = (export_file != NULL) || (export_env("LPA_BASELINE") != NULL) ||
+                     (export_env("LPA_BASELINE_SAVE") != NULL);
+}
+
+void lpa_export_record(const lpa_hal_call_t *call)
+{
+    uint64_t wall = call->end_ns - call->start_ns;
+
+    pthread_once(&export_once, export_init);
+    if (export_enabled == 0)
+    {
+        return;
+    }
+    pthread_mutex_lock(&export_lock);
+    export_seq++;
+    lpa_hist_record(&export_hist[call->api], wall);
+    if (call->result != RETURN_OK)
+    {
+        export_errors[call->api]++;
+    }
+    if (export_file != NULL)
+    {
+        fprintf(export_file,
+                export_json ? "%s{\"seq\":%llu,\"api\":\"%s\",\"args\":\"%s\",\"result\":%d,\"timeout\":%d,\"wall_ns\":%llu,\"cpu_ns\":%llu}"
+                            : "%s%llu,%s,%s,%d,%d,%llu,%llu\n",
+                (export_json && (export_seq > 1)) ? ",\n" : "",
+                (unsigned long long)export_seq, lpa_api_name[call->api], call->args, call->result, call->timed_out,
+                (unsigned long long)wall, (unsigned long long)call->cpu_ns);
+    }
+    pthread_mutex_unlock(&export_lock);
+}
+
+static int export_find_api(const char *name)
+{
+    int api = 0;
+
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        if (strcmp(lpa_api_name[api], name) == 0)
+        {
+            return api;
+        }
+    }
+    return -1;
+}
+
+static void export_save_baseline(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    int api = 0;
+
+    if (file == NULL)
+    {
+        UT_LOG("LPA_BASELINE_SAVE : unable to create %s", path);
+        return;
+    }
+    fputs("api,calls,median_ns,p99_ns\n", file);
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        if (export_hist[api].count == 0)
+        {
+            continue;
+        }
+        fprintf(file, "%s,%llu,%llu,%llu\n", lpa_api_name[api],
+                (unsigned long long)export_hist[api].count,
+                (unsigned long long)lpa_hist_percentile(&export_hist[api], 50.0),
+                (unsigned long long)lpa_hist_percentile(&export_hist[api], 99.0));
+    }
+    fclose(file);
+    UT_LOG("Baseline saved to %s", path);
+}
+
+/* slower by more than threshold percent, and by more than min_ns so nanosecond jitter is ignored */
+static int export_regressed(uint64_t current, unsigned long long baseline, int threshold, int min_ns)
+{
+    return ((double)current > (double)baseline * (1.0 + (double)threshold / 100.0)) &&
+           (current > baseline + (unsigned long long)min_ns);
+}
+
+static int export_compare_baseline(const char *path, int threshold, int min_ns)
+{
+    FILE *file = fopen(path, "r");
+    char line[EXPORT_LINE_MAX];
+    char name[EXPORT_LINE_MAX];
+    unsigned long long calls = 0;
+    unsigned long long median = 0;
+    unsigned long long p99 = 0;
+    uint64_t cur_median = 0;
+    uint64_t cur_p99 = 0;
+    int regressions = 0;
+    int api = 0;
+
+    if (file == NULL)
+    {
+        UT_LOG("LPA_BASELINE : unable to open %s", path);
+        return 1;
+    }
+    UT_LOG("Baseline comparison with %s, threshold %d%% (latency in microseconds)", path, threshold);
+    UT_LOG("%-52s %12s %12s %12s %12s  %s", "api", "base p50", "p50", "base p99", "p99", "verdict");
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (sscanf(line, "%255[^,],%llu,%llu,%llu", name, &calls, &median, &p99) != 4)
+        {
+            /* header line */
+            continue;
+        }
+        api = export_find_api(name);
+        if (api < 0)
+        {
+            UT_LOG("%-52s unknown API in the baseline", name);
+            continue;
+        }
+        if (export_hist[api].count == 0)
+        {
+            UT_LOG("%-52s %12.1f %12s %12.1f %12s  not called", name, (double)median / 1000.0, "-",
+                   (double)p99 / 1000.0, "-");
+            continue;
+        }
+        cur_median = lpa_hist_percentile(&export_hist[api], 50.0);
+        cur_p99 = lpa_hist_percentile(&export_hist[api], 99.0);
+        if (export_regressed(cur_median, median, threshold, min_ns) || export_regressed(cur_p99, p99, threshold, min_ns))
+        {
+            regressions++;
+        }
+        UT_LOG("%-52s %12.1f %12.1f %12.1f %12.1f  %s", name,
+               (double)median / 1000.0, (double)cur_median / 1000.0,
+               (double)p99 / 1000.0, (double)cur_p99 / 1000.0,
+               export_regressed(cur_median, median, threshold, min_ns) ? "REGRESSED median" :
+               export_regressed(cur_p99, p99, threshold, min_ns) ? "REGRESSED p99" : "ok");
+    }
+    fclose(file);
+    if (regressions > 0)
+    {
+        UT_LOG("%d API(s) regressed past the %d%% threshold", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
+
+int lpa_export_report(void)
+{
+    const char *save = export_env("LPA_BASELINE_SAVE");
+    const char *baseline = export_env("LPA_BASELINE");
+    int status = 0;
+    int api = 0;
+
+    pthread_once(&export_once, export_init);
+    if (export_enabled == 0)
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&export_lock);
+    if (export_file != NULL)
+    {
+        if (export_json)
+        {
+            fputs((export_seq > 0) ? "\n]\n" : "]\n", export_file);
+        }
+        fclose(export_file);
+        export_file = NULL;
+        UT_LOG("%llu HAL calls exported to %s", (unsigned long long)export_seq, getenv("LPA_EXPORT"));
+    }
+    lpa_hist_print_header("HAL calls, errors are calls not returning RETURN_OK");
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        if (export_hist[api].count > 0)
+        {
+            lpa_hist_print_row(lpa_api_name[api], &export_hist[api], export_errors[api]);
+        }
+    }
+    if (save != NULL)
+    {
+        export_save_baseline(save);
+    }
+    if (baseline != NULL)
+    {
+        status = export_compare_baseline(baseline,
+                                         lpa_perf_env_uint("LPA_BASELINE_THRESHOLD", LPA_BASELINE_THRESHOLD_DEFAULT),
+                                         lpa_perf_env_uint("LPA_BASELINE_MIN_NS", LPA_BASELINE_MIN_NS_DEFAULT));
+    }
+    export_enabled = 0;
+    pthread_mutex_unlock(&export_lock);
+    return status;
+}
+
+#endif /* LPA_HAL_WRAP */
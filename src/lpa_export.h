@@ -0,0 +1,50 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_export.h
+*
+* Machine readable record of every HAL call and baseline comparison, part of `make HAL_WRAP=1`.
+*
+* Selected at run time through the environment, nothing is recorded when none of them is set:
+* - LPA_EXPORT=<file> : one record per call (sequence, api, argument class, return code, watchdog
+*   timeout, wall and CPU time in ns), a JSON array when the name ends in .json, CSV otherwise
+* - LPA_BASELINE_SAVE=<file> : at the end of the run, calls, median and p99 per API as CSV
+* - LPA_BASELINE=<file> : compare the median and p99 of every API with a saved baseline, the run
+*   fails when one of them is more than LPA_BASELINE_THRESHOLD percent (default 10) and more than
+*   LPA_BASELINE_MIN_NS (default 1000) slower
+*/
+
+#ifndef LPA_EXPORT_H
+#define LPA_EXPORT_H
+
+#include "lpa_hal_wrap.h"
+
+#define LPA_BASELINE_THRESHOLD_DEFAULT  10
+#define LPA_BASELINE_MIN_NS_DEFAULT     1000
+
+void lpa_export_record(const lpa_hal_call_t *call);
+
+/**
+ * @brief Close the export, save and compare the baseline as requested
+ *
+ * @return 0, or 1 when an API regressed past the threshold or the baseline could not be read
+ */
+int lpa_export_report(void);
+
+#endif /* LPA_EXPORT_H */
@@ -0,0 +1,255 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifdef LPA_HAL_WRAP
+
+#include <string.h>
+#include "lpa_hal.h"
+#include "lpa_hal_wrap.h"
+#include "lpa_perf.h"
+#include "lpa_export.h"
+#include "lpa_record.h"
+#include "lpa_watchdog.h"
+#ifdef LPA_ALLOC_TRACE
+#include "lpa_alloc_trace.h"
+#endif
+
+const char *const lpa_api_name[LPA_API_MAX] =
+{
+    "cellular_esim_download_profile_with_activationcode",
+    "cellular_esim_download_profile_from_smds",
+    "cellular_esim_download_profile_from_defaultsmdp",
+    "cellular_esim_get_profile_info",
+    "cellular_esim_enable_profile",
+    "cellular_esim_disable_profile",
+    "cellular_esim_delete_profile",
+    "cellular_esim_lpa_init",
+    "cellular_esim_lpa_exit",
+    "cellular_esim_get_eid",
+    "cellular_esim_get_euicc",
+};
+
+void lpa_hal_call_begin(lpa_hal_call_t *call, lpa_api_t api, const char *args)
+{
+    call->api = api;
+    call->args = args;
+    call->result = 0;
+    call->end_ns = 0;
+    call->cpu_ns = 0;
+    call->timed_out = 0;
+    call->cpu_start_ns = lpa_perf_cpu_ns();
+    call->start_ns = lpa_perf_now_ns();
+}
+
+void lpa_hal_call_end(lpa_hal_call_t *call, int result)
+{
+    call->end_ns = lpa_perf_now_ns();
+    call->cpu_ns = lpa_perf_cpu_ns() - call->cpu_start_ns;
+    call->result = result;
+    lpa_export_record(call);
+}
+
+int lpa_hal_wrap_report(void)
+{
+#ifdef LPA_ALLOC_TRACE
+    lpa_alloc_trace_report();
+#endif
+    lpa_record_report();
+    lpa_watchdog_report();
+    return lpa_export_report();
+}
+
+/* Argument classes of the export records */
+static const char *wrap_args_string(const char *value)
+{
+    if (value == NULL)
+    {
+        return "null";
+    }
+    return (*value == '\0') ? "empty" : "value";
+}
+
+static const char *wrap_args_iccid(const char *iccid, int iccid_size)
+{
+    if ((iccid == NULL) || (*iccid == '\0'))
+    {
+        return wrap_args_string(iccid);
+    }
+    return ((int)strlen(iccid) != iccid_size) ? "size_mismatch" : "value";
+}
+
+/* Implementations reached through -Wl,--wrap */
+int __real_cellular_esim_download_profile_with_activationcode(char* ActivationCodeStr, cellular_sim_download_progress_callback download_progress);
+int __real_cellular_esim_download_profile_from_smds(char* smds);
+int __real_cellular_esim_download_profile_from_defaultsmdp(char* smdp);
+int __real_cellular_esim_get_profile_info(eSIMProfileStruct** profile_list, int* nb_profiles);
+int __real_cellular_esim_enable_profile(char* iccid, int iccid_size);
+int __real_cellular_esim_disable_profile(char* iccid, int iccid_size);
+int __real_cellular_esim_delete_profile(char* iccid, int iccid_size);
+int __real_cellular_esim_lpa_init(void);
+int __real_cellular_esim_lpa_exit(void);
+int __real_cellular_esim_get_eid(void);
+int __real_cellular_esim_get_euicc(void);
+
+static int wrap_forward(lpa_api_t api, const lpa_hal_params_t *params)
+{
+    switch (api)
+    {
+        case LPA_API_DOWNLOAD_ACTIVATIONCODE:
+            return __real_cellular_esim_download_profile_with_activationcode(params->text, lpa_record_progress_hook(params->progress));
+        case LPA_API_DOWNLOAD_SMDS:
+            return __real_cellular_esim_download_profile_from_smds(params->text);
+        case LPA_API_DOWNLOAD_DEFAULTSMDP:
+            return __real_cellular_esim_download_profile_from_defaultsmdp(params->text);
+        case LPA_API_GET_PROFILE_INFO:
+            return __real_cellular_esim_get_profile_info(params->profile_list, params->nb_profiles);
+        case LPA_API_ENABLE_PROFILE:
+            return __real_cellular_esim_enable_profile(params->text, params->size);
+        case LPA_API_DISABLE_PROFILE:
+            return __real_cellular_esim_disable_profile(params->text, params->size);
+        case LPA_API_DELETE_PROFILE:
+            return __real_cellular_esim_delete_profile(params->text, params->size);
+        case LPA_API_LPA_INIT:
+            return __real_cellular_esim_lpa_init();
+        case LPA_API_LPA_EXIT:
+            return __real_cellular_esim_lpa_exit();
+        case LPA_API_GET_EID:
+            return __real_cellular_esim_get_eid();
+        case LPA_API_GET_EUICC:
+            return __real_cellular_esim_get_euicc();
+        default:
+            return RETURN_ERROR;
+    }
+}
+
+/*
+ * Forward one call to the implementation, on the caller's thread or on the watchdog's. The heap
+ * accounting brackets only the implementation, on the thread running it, so the watchdog's own
+ * job and thread are not charged to the API.
+ */
+static int wrap_invoke(lpa_api_t api, const lpa_hal_params_t *params)
+{
+    int result = 0;
+
+#ifdef LPA_ALLOC_TRACE
+    lpa_alloc_trace_begin(api);
+#endif
+    result = wrap_forward(api, params);
+#ifdef LPA_ALLOC_TRACE
+    lpa_alloc_trace_end(api);
+#endif
+    return result;
+}
+
+static lpa_hal_params_t wrap_params(char *text, int size, eSIMProfileStruct **profile_list, int *nb_profiles,
+                                    cellular_sim_download_progress_callback progress)
+{
+    lpa_hal_params_t params;
+
+    params.text = text;
+    params.size = size;
+    params.profile_list = profile_list;
+    params.nb_profiles = nb_profiles;
+    params.progress = progress;
+    return params;
+}
+
+/* Served from LPA_REPLAY when replaying, under the watchdog otherwise, and recorded to LPA_RECORD */
+static int wrap_call(lpa_api_t api, const char *args, lpa_hal_params_t params)
+{
+    lpa_hal_call_t call;
+    int result = 0;
+
+    lpa_hal_call_begin(&call, api, args);
+    if (lpa_replay_enabled())
+    {
+#ifdef LPA_ALLOC_TRACE
+        lpa_alloc_trace_begin(api);
+#endif
+        result = lpa_replay_call(api, &params);
+#ifdef LPA_ALLOC_TRACE
+        lpa_alloc_trace_end(api);
+#endif
+    }
+    else
+    {
+        result = lpa_watchdog_call(&call, wrap_invoke, &params);
+    }
+    lpa_hal_call_end(&call, result);
+    lpa_record_call(&call, &params);
+    return result;
+}
+
+int __wrap_cellular_esim_download_profile_with_activationcode(char* ActivationCodeStr, cellular_sim_download_progress_callback download_progress)
+{
+    return wrap_call(LPA_API_DOWNLOAD_ACTIVATIONCODE, wrap_args_string(ActivationCodeStr),
+                     wrap_params(ActivationCodeStr, 0, NULL, NULL, download_progress));
+}
+
+int __wrap_cellular_esim_download_profile_from_smds(char* smds)
+{
+    return wrap_call(LPA_API_DOWNLOAD_SMDS, wrap_args_string(smds), wrap_params(smds, 0, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_download_profile_from_defaultsmdp(char* smdp)
+{
+    return wrap_call(LPA_API_DOWNLOAD_DEFAULTSMDP, wrap_args_string(smdp), wrap_params(smdp, 0, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_get_profile_info(eSIMProfileStruct** profile_list, int* nb_profiles)
+{
+    return wrap_call(LPA_API_GET_PROFILE_INFO, ((profile_list == NULL) || (nb_profiles == NULL)) ? "null" : "value",
+                     wrap_params(NULL, 0, profile_list, nb_profiles, NULL));
+}
+
+int __wrap_cellular_esim_enable_profile(char* iccid, int iccid_size)
+{
+    return wrap_call(LPA_API_ENABLE_PROFILE, wrap_args_iccid(iccid, iccid_size), wrap_params(iccid, iccid_size, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_disable_profile(char* iccid, int iccid_size)
+{
+    return wrap_call(LPA_API_DISABLE_PROFILE, wrap_args_iccid(iccid, iccid_size), wrap_params(iccid, iccid_size, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_delete_profile(char* iccid, int iccid_size)
+{
+    return wrap_call(LPA_API_DELETE_PROFILE, wrap_args_iccid(iccid, iccid_size), wrap_params(iccid, iccid_size, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_lpa_init(void)
+{
+    return wrap_call(LPA_API_LPA_INIT, "none", wrap_params(NULL, 0, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_lpa_exit(void)
+{
+    return wrap_call(LPA_API_LPA_EXIT, "none", wrap_params(NULL, 0, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_get_eid(void)
+{
+    return wrap_call(LPA_API_GET_EID, "none", wrap_params(NULL, 0, NULL, NULL, NULL));
+}
+
+int __wrap_cellular_esim_get_euicc(void)
+{
+    return wrap_call(LPA_API_GET_EUICC, "none", wrap_params(NULL, 0, NULL, NULL, NULL));
+}
+
+#endif /* LPA_HAL_WRAP */
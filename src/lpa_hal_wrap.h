@@ -0,0 +1,95 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_hal_wrap.h
+*
+* Instrumentation layer around the HAL calls, built with `make HAL_WRAP=1`.
+*
+* Every cellular_esim_* API is linked with `-Wl,--wrap=<api>`, so the calls made by the test suites
+* reach __wrap_<api> in lpa_hal_wrap.c, which brackets the vendor (or simulator) implementation
+* with lpa_hal_call_begin() / lpa_hal_call_end(). The instruments selected at build time hook in
+* there, without any change to the suites nor to the library under test:
+* - LPA_ALLOC_TRACE (`make ALLOC_TRACE=1`) : heap accounting per API, see lpa_alloc_trace.h
+*
+* The per call export and baseline comparison of lpa_export.h, the record / replay of lpa_record.h
+* and the deadline watchdog of lpa_watchdog.h are always part of the layer and enabled through
+* the environment.
+*/
+
+#ifndef LPA_HAL_WRAP_H
+#define LPA_HAL_WRAP_H
+
+#include <stdint.h>
+#include "lpa_hal.h"
+
+typedef enum
+{
+    LPA_API_DOWNLOAD_ACTIVATIONCODE = 0,
+    LPA_API_DOWNLOAD_SMDS,
+    LPA_API_DOWNLOAD_DEFAULTSMDP,
+    LPA_API_GET_PROFILE_INFO,
+    LPA_API_ENABLE_PROFILE,
+    LPA_API_DISABLE_PROFILE,
+    LPA_API_DELETE_PROFILE,
+    LPA_API_LPA_INIT,
+    LPA_API_LPA_EXIT,
+    LPA_API_GET_EID,
+    LPA_API_GET_EUICC,
+    LPA_API_MAX
+} lpa_api_t;
+
+extern const char *const lpa_api_name[LPA_API_MAX];
+
+/* One HAL call in flight */
+typedef struct
+{
+    lpa_api_t api;
+    const char *args;           /* class of the arguments: none, null, empty, size_mismatch or value */
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t cpu_start_ns;
+    uint64_t cpu_ns;            /* CPU time of the calling thread spent in the call */
+    int result;
+    int timed_out;              /* abandoned by the watchdog, result is RETURN_ERROR */
+} lpa_hal_call_t;
+
+/* Arguments of one call, the fields an API does not take are NULL / 0 */
+typedef struct
+{
+    char *text;                         /* activation code, smds, smdp or iccid */
+    int size;                           /* iccid_size */
+    eSIMProfileStruct **profile_list;   /* get_profile_info outputs */
+    int *nb_profiles;
+    cellular_sim_download_progress_callback progress;
+} lpa_hal_params_t;
+
+/* Forwards a call to the implementation under test */
+typedef int (*lpa_hal_invoke_t)(lpa_api_t api, const lpa_hal_params_t *params);
+
+void lpa_hal_call_begin(lpa_hal_call_t *call, lpa_api_t api, const char *args);
+void lpa_hal_call_end(lpa_hal_call_t *call, int result);
+
+/**
+ * @brief Print the reports of the instruments built in, called once the suites have run
+ *
+ * @return 0, or 1 when the baseline comparison failed
+ */
+int lpa_hal_wrap_report(void);
+
+#endif /* LPA_HAL_WRAP_H */
@@ -0,0 +1,184 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include "lpa_iccid.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Luhn value of a digit in a doubled position */
+static const uint8_t luhn_doubled[10] = { 0, 2, 4, 6, 8, 1, 3, 5, 7, 9 };
+
+lpa_iccid_status_t lpa_iccid_check(const char *text, size_t len)
+{
+    unsigned int sum = 0;
+    size_t i = 0;
+
+    if ((text == NULL) || (len < LPA_ICCID_MIN_DIGITS) || (len > LPA_ICCID_MAX_DIGITS))
+    {
+        return LPA_ICCID_BAD_LENGTH;
+    }
+    for (i = 0; i < len; i++)
+    {
+        unsigned int digit = (unsigned int)(unsigned char)text[i] - '0';
+
+        if (digit > 9)
+        {
+            return LPA_ICCID_BAD_DIGIT;
+        }
+        /* every second digit counting left from the check digit is doubled */
+        sum += ((len - i) % 2 == 0) ? luhn_doubled[digit] : digit;
+    }
+    return (sum % 10 == 0) ? LPA_ICCID_OK : LPA_ICCID_BAD_LUHN;
+}
+
+char lpa_iccid_check_digit(const char *text, size_t len)
+{
+    unsigned int sum = 0;
+    size_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        unsigned int digit = (unsigned int)(unsigned char)text[i] - '0';
+
+        /* the check digit takes position len, so the digits an odd distance left of it are doubled */
+        sum += ((len - i) % 2 == 1) ? luhn_doubled[digit] : digit;
+    }
+    return (char)('0' + ((10 - (sum % 10)) % 10));
+}
+
+lpa_iccid_status_t lpa_iccid_pack(const char *text, size_t len, lpa_iccid_t *out)
+{
+    size_t i = 0;
+
+    if ((text == NULL) || (len < LPA_ICCID_MIN_DIGITS) || (len > LPA_ICCID_MAX_DIGITS))
+    {
+        return LPA_ICCID_BAD_LENGTH;
+    }
+    memset(out->bcd, 0xff, sizeof(out->bcd));
+    for (i = 0; i < len; i++)
+    {
+        unsigned int digit = (unsigned int)(unsigned char)text[i] - '0';
+
+        if (digit > 9)
+        {
+            return LPA_ICCID_BAD_DIGIT;
+        }
+        if (i % 2 == 0)
+        {
+            out->bcd[i / 2] = (uint8_t)(0xf0 | digit);
+        }
+        else
+        {
+            out->bcd[i / 2] = (uint8_t)((out->bcd[i / 2] & 0x0f) | (digit << 4));
+        }
+    }
+    return LPA_ICCID_OK;
+}
+
+int lpa_iccid_compare(const lpa_iccid_t *a, const lpa_iccid_t *b)
+{
+    return memcmp(a->bcd, b->bcd, LPA_ICCID_BCD_BYTES);
+}
+
+#if defined(__SSE2__)
+/* Checks one NUL padded slot with two 16 byte vectors, no branch per digit */
+static lpa_iccid_status_t iccid_check_slot(const char *slot)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ascii_zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i index_lo = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i index_hi = _mm_setr_epi8(16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+    const __m128i even = _mm_setr_epi8(-1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0);
+    __m128i lo = _mm_loadu_si128((const __m128i *)slot);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(slot + 16));
+    __m128i len_vec;
+    __m128i doubled_pos;
+    __m128i d_lo;
+    __m128i d_hi;
+    __m128i v_lo;
+    __m128i v_hi;
+    __m128i sums;
+    uint32_t nul = 0;
+    uint32_t digits = 0;
+    uint32_t need = 0;
+    unsigned int len = 0;
+
+    nul = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(lo, zero)) | ((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(hi, zero)) << 16);
+    len = (nul != 0) ? (unsigned int)__builtin_ctz(nul) : LPA_ICCID_SLOT;
+    if ((len < LPA_ICCID_MIN_DIGITS) || (len > LPA_ICCID_MAX_DIGITS))
+    {
+        return LPA_ICCID_BAD_LENGTH;
+    }
+
+    /* a byte is a digit when (c - '0') is 0..9 as an unsigned value */
+    d_lo = _mm_sub_epi8(lo, ascii_zero);
+    d_hi = _mm_sub_epi8(hi, ascii_zero);
+    digits = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d_lo, nine), d_lo)) |
+             ((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d_hi, nine), d_hi)) << 16);
+    need = (1U << len) - 1U;
+    if ((digits & need) != need)
+    {
+        return LPA_ICCID_BAD_DIGIT;
+    }
+
+    /* Luhn: positions with the same parity as len are doubled, 2d > 9 becomes 2d - 9 */
+    doubled_pos = (len % 2 == 0) ? even : _mm_andnot_si128(even, _mm_set1_epi8(-1));
+    len_vec = _mm_set1_epi8((char)len);
+    v_lo = _mm_add_epi8(d_lo, d_lo);
+    v_lo = _mm_sub_epi8(v_lo, _mm_and_si128(_mm_cmpgt_epi8(v_lo, nine), nine));
+    v_lo = _mm_or_si128(_mm_and_si128(doubled_pos, v_lo), _mm_andnot_si128(doubled_pos, d_lo));
+    v_lo = _mm_and_si128(v_lo, _mm_cmplt_epi8(index_lo, len_vec));
+    v_hi = _mm_add_epi8(d_hi, d_hi);
+    v_hi = _mm_sub_epi8(v_hi, _mm_and_si128(_mm_cmpgt_epi8(v_hi, nine), nine));
+    v_hi = _mm_or_si128(_mm_and_si128(doubled_pos, v_hi), _mm_andnot_si128(doubled_pos, d_hi));
+    v_hi = _mm_and_si128(v_hi, _mm_cmplt_epi8(index_hi, len_vec));
+    sums = _mm_add_epi64(_mm_sad_epu8(v_lo, zero), _mm_sad_epu8(v_hi, zero));
+    sums = _mm_add_epi64(sums, _mm_unpackhi_epi64(sums, sums));
+    return ((_mm_cvtsi128_si32(sums) % 10) == 0) ? LPA_ICCID_OK : LPA_ICCID_BAD_LUHN;
+}
+#else
+static lpa_iccid_status_t iccid_check_slot(const char *slot)
+{
+    return lpa_iccid_check(slot, strnlen(slot, LPA_ICCID_SLOT));
+}
+#endif
+
+size_t lpa_iccid_check_slots(const char *slots, size_t count, size_t stride, uint8_t *status)
+{
+    size_t valid = 0;
+    size_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        lpa_iccid_status_t result = iccid_check_slot(slots + (i * stride));
+
+        if (status != NULL)
+        {
+            status[i] = (uint8_t)result;
+        }
+        if (result == LPA_ICCID_OK)
+        {
+            valid++;
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,91 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_iccid.h
+*
+* Compact ICCID representation and validation.
+*
+* An ICCID (ITU-T E.118) is 18 to 20 decimal digits, the last one being a Luhn check digit.
+* lpa_iccid_t packs it in 10 bytes of BCD with the nibble order of the EF.ICCID file on the
+* SIM (first digit in the low nibble) and 0xF filling the unused nibbles, so two ICCIDs are
+* compared with a single 10 byte memcmp. The simulator keys its profile table with it.
+*
+* lpa_iccid_check_slots() validates digits, length and check digit of many ICCIDs held in
+* fixed width, NUL padded text slots, like the iccid table of the config cache. It uses SSE2 when
+* available and a scalar loop otherwise. The L1 suite checks the configured ICCIDs with it.
+*/
+
+#ifndef LPA_ICCID_H
+#define LPA_ICCID_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LPA_ICCID_BCD_BYTES   10
+#define LPA_ICCID_MIN_DIGITS  18
+#define LPA_ICCID_MAX_DIGITS  20
+/* Width of one text slot for lpa_iccid_check_slots(), the text is NUL padded up to it */
+#define LPA_ICCID_SLOT        32
+
+typedef struct
+{
+    uint8_t bcd[LPA_ICCID_BCD_BYTES];
+} lpa_iccid_t;
+
+typedef enum
+{
+    LPA_ICCID_OK = 0,
+    LPA_ICCID_BAD_LENGTH,
+    LPA_ICCID_BAD_DIGIT,
+    LPA_ICCID_BAD_LUHN
+} lpa_iccid_status_t;
+
+/**
+ * @brief Check digits, length and Luhn check digit of `len` characters of text
+ */
+lpa_iccid_status_t lpa_iccid_check(const char *text, size_t len);
+
+/**
+ * @brief Luhn check digit completing `len` decimal digits, as the character to append
+ *
+ * The digits are not validated, the caller generates them.
+ */
+char lpa_iccid_check_digit(const char *text, size_t len);
+
+/**
+ * @brief Pack a textual ICCID, the check digit is not verified
+ *
+ * @return LPA_ICCID_OK, LPA_ICCID_BAD_LENGTH or LPA_ICCID_BAD_DIGIT
+ */
+lpa_iccid_status_t lpa_iccid_pack(const char *text, size_t len, lpa_iccid_t *out);
+
+int lpa_iccid_compare(const lpa_iccid_t *a, const lpa_iccid_t *b);
+
+/**
+ * @brief Validate `count` ICCIDs stored in text slots `stride` bytes apart
+ *
+ * Every slot must be at least LPA_ICCID_SLOT bytes (stride >= LPA_ICCID_SLOT) and is read whole,
+ * the ICCID is the text up to the first NUL. `status`, when not NULL, receives one
+ * lpa_iccid_status_t per slot.
+ *
+ * @return number of valid ICCIDs
+ */
+size_t lpa_iccid_check_slots(const char *slots, size_t count, size_t stride, uint8_t *status);
+
+#endif /* LPA_ICCID_H */
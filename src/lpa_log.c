@@ -0,0 +1,232 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lpa_log.h"
+
+/*
+ * Bounded ring after D. Vyukov: a slot is free for the writer claiming position p when its
+ * sequence is p, and readable by the drain thread when its sequence is p + 1.
+ */
+typedef struct
+{
+    uint64_t sequence;
+    char text[LPA_LOG_LINE];
+} log_slot_t;
+
+int lpa_log_level = -1;
+
+static log_slot_t log_ring[LPA_LOG_SLOTS];
+static uint64_t log_head = 0;           /* next position to claim */
+static uint64_t log_tail = 0;           /* next position to drain, written by the drain thread */
+static int log_async = 0;
+static int log_started = 0;
+static int log_stop = 0;
+static pthread_t log_thread;
+static pid_t log_thread_pid = 0;        /* process that started log_thread, 0 when there is none */
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+
+static void log_sleep_us(long us)
+{
+    struct timespec ts;
+
+    ts.tv_sec = 0;
+    ts.tv_nsec = us * 1000L;
+    nanosleep(&ts, NULL);
+}
+
+static void *log_drain(void *arg)
+{
+    uint64_t position = __atomic_load_n(&log_tail, __ATOMIC_RELAXED);
+
+    (void)arg;
+    for (;;)
+    {
+        log_slot_t *slot = &log_ring[position & (LPA_LOG_SLOTS - 1)];
+
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != position + 1)
+        {
+            if (__atomic_load_n(&log_stop, __ATOMIC_ACQUIRE))
+            {
+                break;
+            }
+            log_sleep_us(1000);
+            continue;
+        }
+        UT_LOG("%s", slot->text);
+        __atomic_store_n(&slot->sequence, position + LPA_LOG_SLOTS, __ATOMIC_RELEASE);
+        position++;
+        __atomic_store_n(&log_tail, position, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+/* Registered once per process tree, a forked child only joins a thread it started itself */
+static void log_exit(void)
+{
+    if (log_thread_pid != getpid())
+    {
+        return;
+    }
+    lpa_log_flush();
+    __atomic_store_n(&log_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(log_thread, NULL);
+    log_thread_pid = 0;
+}
+
+/* A forked child has the ring but not the thread: start over */
+static void log_atfork_child(void)
+{
+    uint64_t i = 0;
+
+    pthread_mutex_init(&log_lock, NULL);
+    for (i = 0; i < LPA_LOG_SLOTS; i++)
+    {
+        log_ring[i].sequence = i;
+    }
+    log_head = 0;
+    log_tail = 0;
+    log_started = 0;
+    log_stop = 0;
+    log_thread_pid = 0;
+}
+
+static void log_register(void)
+{
+    atexit(log_exit);
+    pthread_atfork(NULL, NULL, log_atfork_child);
+}
+
+static void log_start(void)
+{
+    const char *level = getenv("LPA_LOG_LEVEL");
+    const char *async = getenv("LPA_LOG_ASYNC");
+    int value = LPA_LOG_LEVEL_INFO;
+    uint64_t i = 0;
+
+    pthread_mutex_lock(&log_lock);
+    if (log_started)
+    {
+        pthread_mutex_unlock(&log_lock);
+        return;
+    }
+    if (level != NULL)
+    {
+        value = !strcasecmp(level, "error") ? LPA_LOG_LEVEL_ERROR :
+                !strcasecmp(level, "warn") ? LPA_LOG_LEVEL_WARN :
+                !strcasecmp(level, "debug") ? LPA_LOG_LEVEL_DEBUG : LPA_LOG_LEVEL_INFO;
+    }
+    for (i = 0; i < LPA_LOG_SLOTS; i++)
+    {
+        log_ring[i].sequence = i;
+    }
+    log_async = ((async == NULL) || strcmp(async, "0")) ? 1 : 0;
+    if (log_async && (pthread_create(&log_thread, NULL, log_drain, NULL) != 0))
+    {
+        log_async = 0;
+    }
+    if (log_async)
+    {
+        log_thread_pid = getpid();
+        pthread_once(&log_once, log_register);
+    }
+    __atomic_store_n(&lpa_log_level, value, __ATOMIC_RELEASE);
+    __atomic_store_n(&log_started, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&log_lock);
+}
+
+void lpa_log_write(lpa_log_level_t level, const char *format, ...)
+{
+    log_slot_t *slot = NULL;
+    uint64_t position = 0;
+    va_list args;
+
+    if (!__atomic_load_n(&log_started, __ATOMIC_ACQUIRE))
+    {
+        log_start();
+        if ((int)level > __atomic_load_n(&lpa_log_level, __ATOMIC_RELAXED))
+        {
+            return;
+        }
+    }
+    if (!log_async || (level == LPA_LOG_LEVEL_ERROR))
+    {
+        char text[LPA_LOG_LINE];
+
+        va_start(args, format);
+        vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        lpa_log_flush();
+        UT_LOG("%s", text);
+        return;
+    }
+    position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        int64_t lag = 0;
+
+        slot = &log_ring[position & (LPA_LOG_SLOTS - 1)];
+        lag = (int64_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+        if (lag == 0)
+        {
+            if (__atomic_compare_exchange_n(&log_head, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (lag < 0)
+        {
+            /* full, wait for the drain thread rather than lose the line */
+            sched_yield();
+            position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            position = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+        }
+    }
+    va_start(args, format);
+    vsnprintf(slot->text, sizeof(slot->text), format, args);
+    va_end(args);
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+void lpa_log_flush(void)
+{
+    if (!__atomic_load_n(&log_started, __ATOMIC_ACQUIRE) || !log_async)
+    {
+        return;
+    }
+    while (__atomic_load_n(&log_tail, __ATOMIC_ACQUIRE) != __atomic_load_n(&log_head, __ATOMIC_ACQUIRE))
+    {
+        log_sleep_us(100);
+    }
+}
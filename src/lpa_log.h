@@ -0,0 +1,76 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_log.h
+*
+* Asynchronous logging for the loops and timed sections of the suites, where a synchronous UT_LOG
+* per line makes the console the bottleneck.
+*
+* LPA_LOG_*() formats the line into a slot of a bounded ring, claimed with a compare and swap, and
+* returns: no lock, no I/O. A background thread started on the first line drains the ring
+* through UT_LOG. The ring is sized for bursts; when it is full the writer waits for a slot
+* rather than losing the line. lpa_log_flush() waits for the ring to drain, call it before going
+* back to UT_LOG so the output keeps its order. LPA_LOG_ERROR() flushes and writes synchronously.
+*
+* - LPA_LOG_LEVEL : error, warn, info (default) or debug, the lines above it are filtered out
+*   before being formatted
+* - LPA_LOG_ASYNC : 0 writes every line synchronously, when debugging a crash that would lose the
+*   queued lines
+*/
+
+#ifndef LPA_LOG_H
+#define LPA_LOG_H
+
+#define LPA_LOG_SLOTS   1024    /* power of two */
+#define LPA_LOG_LINE    256
+
+typedef enum
+{
+    LPA_LOG_LEVEL_ERROR = 0,
+    LPA_LOG_LEVEL_WARN,
+    LPA_LOG_LEVEL_INFO,
+    LPA_LOG_LEVEL_DEBUG
+} lpa_log_level_t;
+
+/* -1 until LPA_LOG_LEVEL has been read */
+extern int lpa_log_level;
+
+void lpa_log_write(lpa_log_level_t level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Wait until the background thread has written every queued line
+ */
+void lpa_log_flush(void);
+
+#define LPA_LOG(level, ...) \
+    do \
+    { \
+        int lpa_log_level_ = __atomic_load_n(&lpa_log_level, __ATOMIC_RELAXED); \
+        if ((lpa_log_level_ < 0) || ((int)(level) <= lpa_log_level_)) \
+        { \
+            lpa_log_write((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LPA_LOG_ERROR(...)  LPA_LOG(LPA_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LPA_LOG_WARN(...)   LPA_LOG(LPA_LOG_LEVEL_WARN, __VA_ARGS__)
+#define LPA_LOG_INFO(...)   LPA_LOG(LPA_LOG_LEVEL_INFO, __VA_ARGS__)
+#define LPA_LOG_DEBUG(...)  LPA_LOG(LPA_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif /* LPA_LOG_H */
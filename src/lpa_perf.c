@@ -0,0 +1,394 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include "lpa_hal.h"
+#include "lpa_perf.h"
+#include "lpa_trace.h"
+
+/* Set once by the first lpa_perf_hal_init() of the process */
+static uint64_t perf_cold_init_ns = 0;
+
+uint64_t lpa_perf_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t lpa_perf_cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+int lpa_perf_hal_init(void)
+{
+    uint64_t start = lpa_perf_now_ns();
+    int ret = LPA_TRACE_CALL(cellular_esim_lpa_init);
+    uint64_t elapsed = lpa_perf_now_ns() - start;
+    uint64_t unset = 0;
+
+    /* at least 1 ns, 0 meaning no init yet */
+    (void)__atomic_compare_exchange_n(&perf_cold_init_ns, &unset, (elapsed > 0) ? elapsed : 1, 0,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    return ret;
+}
+
+uint64_t lpa_perf_cold_init_ns(void)
+{
+    return __atomic_load_n(&perf_cold_init_ns, __ATOMIC_RELAXED);
+}
+
+static int perf_env_range(const char *name, int def, long min)
+{
+    const char *value = getenv(name);
+    char *end = NULL;
+    long parsed = 0;
+
+    if ((value == NULL) || (*value == '\0'))
+    {
+        return def;
+    }
+    parsed = strtol(value, &end, 10);
+    if ((*end != '\0') || (parsed < min) || (parsed > 0x7fffffffL))
+    {
+        UT_LOG("Ignoring invalid %s=%s, using %d", name, value, def);
+        return def;
+    }
+    return (int)parsed;
+}
+
+int lpa_perf_env_int(const char *name, int def)
+{
+    return perf_env_range(name, def, 1);
+}
+
+int lpa_perf_env_uint(const char *name, int def)
+{
+    return perf_env_range(name, def, 0);
+}
+
+long lpa_perf_rss_kb(void)
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    long pages = 0;
+    long resident = 0;
+
+    if (file == NULL)
+    {
+        return 0;
+    }
+    if (fscanf(file, "%ld %ld", &pages, &resident) != 2)
+    {
+        resident = 0;
+    }
+    fclose(file);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+int lpa_perf_fd_count(void)
+{
+    DIR *dir = opendir("/proc/self/fd");
+    struct dirent *entry = NULL;
+    int count = 0;
+
+    if (dir == NULL)
+    {
+        return -1;
+    }
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] != '.')
+        {
+            count++;
+        }
+    }
+    closedir(dir);
+    /* the descriptor of the directory stream itself */
+    return count - 1;
+}
+
+int lpa_perf_thread_count(void)
+{
+    FILE *file = fopen("/proc/self/status", "r");
+    char line[128];
+    int threads = -1;
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (sscanf(line, "Threads: %d", &threads) == 1)
+        {
+            break;
+        }
+    }
+    fclose(file);
+    return threads;
+}
+
+/* Values below LPA_HIST_SUB_COUNT get one bucket each, above that each power of two gets LPA_HIST_SUB_COUNT buckets */
+static unsigned int hist_index(uint64_t ns)
+{
+    unsigned int msb = 0;
+    unsigned int shift = 0;
+
+    if (ns < LPA_HIST_SUB_COUNT)
+    {
+        return (unsigned int)ns;
+    }
+    msb = 63U - (unsigned int)__builtin_clzll(ns);
+    shift = msb - LPA_HIST_SUB_BITS;
+    return ((shift + 1U) << LPA_HIST_SUB_BITS) + (unsigned int)((ns >> shift) & (LPA_HIST_SUB_COUNT - 1));
+}
+
+static uint64_t hist_bucket_upper(unsigned int index)
+{
+    unsigned int group = index >> LPA_HIST_SUB_BITS;
+    uint64_t sub = index & (LPA_HIST_SUB_COUNT - 1);
+
+    if (group == 0)
+    {
+        return sub;
+    }
+    return ((LPA_HIST_SUB_COUNT + sub + 1) << (group - 1)) - 1;
+}
+
+void lpa_hist_reset(lpa_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+void lpa_hist_record(lpa_hist_t *hist, uint64_t ns)
+{
+    hist->buckets[hist_index(ns)]++;
+    hist->count++;
+    hist->sum += ns;
+    if (ns < hist->min)
+    {
+        hist->min = ns;
+    }
+    if (ns > hist->max)
+    {
+        hist->max = ns;
+    }
+}
+
+void lpa_hist_merge(lpa_hist_t *dst, const lpa_hist_t *src)
+{
+    int i = 0;
+
+    if (src->count == 0)
+    {
+        return;
+    }
+    for (i = 0; i < LPA_HIST_BUCKETS; i++)
+    {
+        dst->buckets[i] += src->buckets[i];
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min)
+    {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max)
+    {
+        dst->max = src->max;
+    }
+}
+
+uint64_t lpa_hist_percentile(const lpa_hist_t *hist, double percentile)
+{
+    uint64_t rank = 0;
+    uint64_t seen = 0;
+    uint64_t upper = 0;
+    int i = 0;
+
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+    rank = (uint64_t)((percentile / 100.0) * (double)hist->count + 0.5);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    if (rank > hist->count)
+    {
+        rank = hist->count;
+    }
+    for (i = 0; i < LPA_HIST_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+        {
+            upper = hist_bucket_upper((unsigned int)i);
+            return (upper > hist->max) ? hist->max : upper;
+        }
+    }
+    return hist->max;
+}
+
+void lpa_hist_print_header(const char *title)
+{
+    UT_LOG("%s (latency in microseconds)", title);
+    UT_LOG("%-52s %8s %6s %10s %10s %10s %10s %10s %10s %10s",
+           "api", "calls", "errors", "min", "mean", "p50", "p90", "p99", "p99.9", "max");
+}
+
+void lpa_hist_print_row(const char *name, const lpa_hist_t *hist, int errors)
+{
+    if (hist->count == 0)
+    {
+        UT_LOG("%-52s %8s", name, "skipped");
+        return;
+    }
+    UT_LOG("%-52s %8llu %6d %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f",
+           name, (unsigned long long)hist->count, errors,
+           (double)hist->min / 1000.0,
+           ((double)hist->sum / (double)hist->count) / 1000.0,
+           (double)lpa_hist_percentile(hist, 50.0) / 1000.0,
+           (double)lpa_hist_percentile(hist, 90.0) / 1000.0,
+           (double)lpa_hist_percentile(hist, 99.0) / 1000.0,
+           (double)lpa_hist_percentile(hist, 99.9) / 1000.0,
+           (double)hist->max / 1000.0);
+}
+
+static pthread_mutex_t progress_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t progress_cond = PTHREAD_COND_INITIALIZER;
+static lpa_progress_trace_t *progress_trace = NULL;
+
+void lpa_progress_begin(lpa_progress_trace_t *trace, long work_us)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->last = -1;
+    trace->monotonic = 1;
+    trace->work_us = work_us;
+    trace->caller = pthread_self();
+    pthread_mutex_lock(&progress_lock);
+    progress_trace = trace;
+    pthread_mutex_unlock(&progress_lock);
+    trace->start_ns = lpa_perf_now_ns();
+}
+
+void lpa_progress_callback(int progress)
+{
+    uint64_t enter = lpa_perf_now_ns();
+    lpa_progress_trace_t *trace = NULL;
+    long work_us = 0;
+    int slot = 0;
+
+    LPA_TRACE_INSTANT("progress", "percent", progress);
+
+    pthread_mutex_lock(&progress_lock);
+    trace = progress_trace;
+    if (trace == NULL)
+    {
+        /* late callback after lpa_progress_end() */
+        pthread_mutex_unlock(&progress_lock);
+        return;
+    }
+    /* the trace lives on the caller's stack, it is only touched under the lock */
+    slot = trace->count++;
+    work_us = trace->work_us;
+    if (progress < trace->last)
+    {
+        trace->monotonic = 0;
+    }
+    trace->last = progress;
+    if (pthread_equal(trace->caller, pthread_self()))
+    {
+        trace->on_caller++;
+    }
+    if (slot < LPA_PROGRESS_MAX)
+    {
+        trace->value[slot] = progress;
+        trace->enter_ns[slot] = enter;
+    }
+    pthread_cond_broadcast(&progress_cond);
+    pthread_mutex_unlock(&progress_lock);
+
+    if (work_us > 0)
+    {
+        usleep((useconds_t)work_us);
+    }
+    if (slot < LPA_PROGRESS_MAX)
+    {
+        pthread_mutex_lock(&progress_lock);
+        if (progress_trace == trace)
+        {
+            trace->leave_ns[slot] = lpa_perf_now_ns();
+        }
+        pthread_mutex_unlock(&progress_lock);
+    }
+}
+
+int lpa_progress_end(lpa_progress_trace_t *trace, int progress, int timeout_ms)
+{
+    struct timespec deadline;
+    int result = 0;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&progress_lock);
+    while ((trace->last < progress) && (result != ETIMEDOUT))
+    {
+        result = pthread_cond_timedwait(&progress_cond, &progress_lock, &deadline);
+    }
+    progress_trace = NULL;
+    pthread_mutex_unlock(&progress_lock);
+    return (trace->last >= progress) ? 0 : -1;
+}
+
+uint64_t lpa_progress_blocked_ns(const lpa_progress_trace_t *trace)
+{
+    uint64_t blocked = 0;
+    int count = (trace->count < LPA_PROGRESS_MAX) ? trace->count : LPA_PROGRESS_MAX;
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (trace->leave_ns[i] > trace->enter_ns[i])
+        {
+            blocked += trace->leave_ns[i] - trace->enter_ns[i];
+        }
+    }
+    return blocked;
+}
@@ -0,0 +1,157 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_perf.h
+*
+* Timing helpers shared by the performance suites.
+*
+* Latencies are recorded in nanoseconds into log-bucketed histograms: every power of two
+* is split into 2^LPA_HIST_SUB_BITS linear sub-buckets, so the relative error of a
+* reported percentile is bounded (~6% with 4 sub-bits) whatever the magnitude.
+*
+* The progress recorder timestamps the download progress callbacks of the HAL. The callback
+* carries no context, so one download at a time is recorded through a process wide trace.
+*/
+
+#ifndef LPA_PERF_H
+#define LPA_PERF_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#define LPA_HIST_SUB_BITS   4
+#define LPA_HIST_SUB_COUNT  (1 << LPA_HIST_SUB_BITS)
+#define LPA_HIST_BUCKETS    ((64 - LPA_HIST_SUB_BITS + 1) * LPA_HIST_SUB_COUNT)
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+    uint64_t buckets[LPA_HIST_BUCKETS];
+} lpa_hist_t;
+
+/**
+ * @brief Monotonic clock in nanoseconds
+ */
+uint64_t lpa_perf_now_ns(void);
+
+/**
+ * @brief CPU time consumed by the calling thread in nanoseconds
+ */
+uint64_t lpa_perf_cpu_ns(void);
+
+/**
+ * @brief cellular_esim_lpa_init(), timed
+ *
+ * Every suite init and the soak mode go through it, so the first call of the process is the real
+ * cold init whichever of them runs first; its duration is kept for the init / exit benchmark.
+ */
+int lpa_perf_hal_init(void);
+
+/**
+ * @brief Duration of the first lpa_perf_hal_init() of the process, 0 before it
+ */
+uint64_t lpa_perf_cold_init_ns(void);
+
+/**
+ * @brief Read an integer tuning value from the environment
+ *
+ * @return the parsed value, or def when the variable is unset or not a positive number
+ */
+int lpa_perf_env_int(const char *name, int def);
+
+/**
+ * @brief Like lpa_perf_env_int() for the values where 0 is meaningful
+ *
+ * @return the parsed value, or def when the variable is unset or not a non-negative number
+ */
+int lpa_perf_env_uint(const char *name, int def);
+
+/**
+ * @brief Resident set size of the process in KiB, 0 when /proc is not available
+ */
+long lpa_perf_rss_kb(void);
+
+/**
+ * @brief Open file descriptors and threads of the process, -1 when /proc is not available
+ */
+int lpa_perf_fd_count(void);
+int lpa_perf_thread_count(void);
+
+void lpa_hist_reset(lpa_hist_t *hist);
+void lpa_hist_record(lpa_hist_t *hist, uint64_t ns);
+void lpa_hist_merge(lpa_hist_t *dst, const lpa_hist_t *src);
+
+/**
+ * @brief Value at the given percentile (0.0 - 100.0), in nanoseconds
+ *
+ * The upper bound of the matching bucket is returned, clamped to the recorded maximum.
+ */
+uint64_t lpa_hist_percentile(const lpa_hist_t *hist, double percentile);
+
+/**
+ * @brief Print the percentile table header / one row per histogram through UT_LOG
+ */
+void lpa_hist_print_header(const char *title);
+void lpa_hist_print_row(const char *name, const lpa_hist_t *hist, int errors);
+
+#define LPA_PROGRESS_MAX     128
+
+typedef struct
+{
+    uint64_t start_ns;                      /* download API invoked */
+    uint64_t return_ns;                     /* download API returned */
+    int count;                              /* callbacks received, may exceed LPA_PROGRESS_MAX */
+    int last;                               /* last progress value, -1 before the first callback */
+    int monotonic;                          /* cleared when a progress value goes backwards */
+    int on_caller;                          /* callbacks run on the thread that invoked the download */
+    long work_us;                           /* time each callback spends before returning */
+    pthread_t caller;
+    int value[LPA_PROGRESS_MAX];
+    uint64_t enter_ns[LPA_PROGRESS_MAX];
+    uint64_t leave_ns[LPA_PROGRESS_MAX];
+} lpa_progress_trace_t;
+
+/**
+ * @brief Start recording into `trace` and stamp start_ns, call right before the download API
+ *
+ * @param work_us emulated work done inside every callback, 0 for a callback that returns at once
+ */
+void lpa_progress_begin(lpa_progress_trace_t *trace, long work_us);
+
+/**
+ * @brief The cellular_sim_download_progress_callback to hand to the download API
+ */
+void lpa_progress_callback(int progress);
+
+/**
+ * @brief Wait until `progress` has been reported or `timeout_ms` elapsed, then stop recording
+ *
+ * @return 0 when the progress value was reached
+ */
+int lpa_progress_end(lpa_progress_trace_t *trace, int progress, int timeout_ms);
+
+/**
+ * @brief Total time spent inside the callbacks, during which the HAL thread reporting progress is held
+ */
+uint64_t lpa_progress_blocked_ns(const lpa_progress_trace_t *trace);
+
+#endif /* LPA_PERF_H */
@@ -0,0 +1,608 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifdef LPA_HAL_WRAP
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include "lpa_record.h"
+#include "lpa_perf.h"
+
+#define RECORD_NULL_TEXT   0xffff
+#define RECORD_MAGIC_LEN   8
+
+typedef struct
+{
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+    int failed;
+} record_buffer_t;
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t length;
+    size_t offset;
+    int failed;
+} record_reader_t;
+
+typedef struct
+{
+    int api;
+    int result;
+    uint64_t latency_ns;
+    char *text;
+    int size;
+    int nb_profiles;                    /* -1 without a list */
+    eSIMProfileStruct *profiles;
+    int nb_progress;
+    int *progress_value;
+    uint64_t *progress_offset_ns;
+} replay_call_t;
+
+static pthread_once_t record_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t record_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* recording */
+static FILE *record_file = NULL;
+static uint64_t record_base_ns = 0;
+static uint64_t record_count = 0;
+static cellular_sim_download_progress_callback record_progress_forward = NULL;
+static int record_progress_count = 0;
+static int record_progress_value[LPA_PROGRESS_MAX];
+static uint64_t record_progress_ns[LPA_PROGRESS_MAX];
+
+/* replay */
+static int replay_enabled = 0;
+static int replay_fast = 0;
+static replay_call_t *replay_calls = NULL;
+static int replay_total = 0;
+static int *replay_index[LPA_API_MAX];
+static int replay_count[LPA_API_MAX];
+static int replay_cursor[LPA_API_MAX];
+static uint64_t replay_served = 0;
+static uint64_t replay_missed = 0;
+
+static void buffer_put(record_buffer_t *buffer, const void *data, size_t length)
+{
+    uint8_t *grown = NULL;
+    size_t capacity = 0;
+
+    if (buffer->length + length > buffer->capacity)
+    {
+        capacity = (buffer->capacity == 0) ? 256 : buffer->capacity;
+        while (buffer->length + length > capacity)
+        {
+            capacity *= 2;
+        }
+        grown = (uint8_t *)realloc(buffer->data, capacity);
+        if (grown == NULL)
+        {
+            buffer->failed = 1;
+            return;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+}
+
+static void buffer_put_uint(record_buffer_t *buffer, uint64_t value, int bytes)
+{
+    uint8_t le[8];
+    int i = 0;
+
+    for (i = 0; i < bytes; i++)
+    {
+        le[i] = (uint8_t)(value >> (8 * i));
+    }
+    buffer_put(buffer, le, (size_t)bytes);
+}
+
+static void buffer_put_text(record_buffer_t *buffer, const char *text, size_t limit, int length_bytes)
+{
+    size_t length = 0;
+
+    if (text == NULL)
+    {
+        buffer_put_uint(buffer, RECORD_NULL_TEXT, length_bytes);
+        return;
+    }
+    length = strnlen(text, limit);
+    buffer_put_uint(buffer, length, length_bytes);
+    buffer_put(buffer, text, length);
+}
+
+static uint64_t reader_get_uint(record_reader_t *reader, int bytes)
+{
+    uint64_t value = 0;
+    int i = 0;
+
+    if (reader->offset + (size_t)bytes > reader->length)
+    {
+        reader->failed = 1;
+        return 0;
+    }
+    for (i = 0; i < bytes; i++)
+    {
+        value |= (uint64_t)reader->data[reader->offset + (size_t)i] << (8 * i);
+    }
+    reader->offset += (size_t)bytes;
+    return value;
+}
+
+static const char *reader_get_bytes(record_reader_t *reader, size_t length)
+{
+    const char *bytes = (const char *)reader->data + reader->offset;
+
+    if (reader->offset + length > reader->length)
+    {
+        reader->failed = 1;
+        return NULL;
+    }
+    reader->offset += length;
+    return bytes;
+}
+
+/* Copy a length prefixed text into a field of the profile structure */
+static void reader_get_field(record_reader_t *reader, char *field, size_t size)
+{
+    size_t length = (size_t)reader_get_uint(reader, 1);
+    const char *text = reader_get_bytes(reader, length);
+
+    if (text == NULL)
+    {
+        return;
+    }
+    if (length >= size)
+    {
+        length = size - 1;
+    }
+    memcpy(field, text, length);
+    field[length] = '\0';
+}
+
+static int replay_parse_call(record_reader_t *reader, replay_call_t *call)
+{
+    size_t length = 0;
+    const char *text = NULL;
+    int i = 0;
+
+    memset(call, 0, sizeof(*call));
+    call->api = (int)reader_get_uint(reader, 1);
+    call->result = (int)(int32_t)reader_get_uint(reader, 4);
+    (void)reader_get_uint(reader, 8);
+    call->latency_ns = reader_get_uint(reader, 8);
+    length = (size_t)reader_get_uint(reader, 2);
+    if (length != RECORD_NULL_TEXT)
+    {
+        text = reader_get_bytes(reader, length);
+        call->text = (char *)malloc(length + 1);
+        if ((text == NULL) || (call->text == NULL))
+        {
+            return -1;
+        }
+        memcpy(call->text, text, length);
+        call->text[length] = '\0';
+    }
+    call->size = (int)(int32_t)reader_get_uint(reader, 4);
+    call->nb_profiles = (int)(int32_t)reader_get_uint(reader, 4);
+    if ((call->nb_profiles > 0) && (reader->failed == 0))
+    {
+        call->profiles = (eSIMProfileStruct *)calloc((size_t)call->nb_profiles, sizeof(eSIMProfileStruct));
+        if (call->profiles == NULL)
+        {
+            return -1;
+        }
+        for (i = 0; (i < call->nb_profiles) && (reader->failed == 0); i++)
+        {
+            reader_get_field(reader, call->profiles[i].iccid, sizeof(call->profiles[i].iccid));
+            reader_get_field(reader, call->profiles[i].profileName, sizeof(call->profiles[i].profileName));
+            call->profiles[i].profileState = (int)(int32_t)reader_get_uint(reader, 4);
+        }
+    }
+    call->nb_progress = (int)reader_get_uint(reader, 2);
+    if ((call->nb_progress > 0) && (reader->failed == 0))
+    {
+        call->progress_value = (int *)calloc((size_t)call->nb_progress, sizeof(int));
+        call->progress_offset_ns = (uint64_t *)calloc((size_t)call->nb_progress, sizeof(uint64_t));
+        if ((call->progress_value == NULL) || (call->progress_offset_ns == NULL))
+        {
+            return -1;
+        }
+        for (i = 0; (i < call->nb_progress) && (reader->failed == 0); i++)
+        {
+            call->progress_value[i] = (int)(int32_t)reader_get_uint(reader, 4);
+            call->progress_offset_ns[i] = reader_get_uint(reader, 8);
+        }
+    }
+    if ((reader->failed != 0) || (call->api < 0) || (call->api >= LPA_API_MAX))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static void replay_free_call(replay_call_t *call)
+{
+    free(call->text);
+    free(call->profiles);
+    free(call->progress_value);
+    free(call->progress_offset_ns);
+}
+
+static int replay_load(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    record_reader_t reader;
+    record_buffer_t content;
+    replay_call_t *grown = NULL;
+    char chunk[4096];
+    size_t length = 0;
+    int capacity = 0;
+    int api = 0;
+    int i = 0;
+
+    if (file == NULL)
+    {
+        UT_LOG("LPA_REPLAY : unable to open %s", path);
+        return -1;
+    }
+    memset(&content, 0, sizeof(content));
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        buffer_put(&content, chunk, length);
+    }
+    fclose(file);
+    if ((content.failed != 0) || (content.length < RECORD_MAGIC_LEN + 4) ||
+        (memcmp(content.data, LPA_RECORD_MAGIC, RECORD_MAGIC_LEN) != 0))
+    {
+        UT_LOG("LPA_REPLAY : %s is not a trace", path);
+        free(content.data);
+        return -1;
+    }
+    reader.data = content.data;
+    reader.length = content.length;
+    reader.offset = RECORD_MAGIC_LEN;
+    reader.failed = 0;
+    if (reader_get_uint(&reader, 4) != LPA_RECORD_VERSION)
+    {
+        UT_LOG("LPA_REPLAY : %s has an unsupported version", path);
+        free(content.data);
+        return -1;
+    }
+    while (reader.offset < reader.length)
+    {
+        if (replay_total == capacity)
+        {
+            capacity = (capacity == 0) ? 64 : capacity * 2;
+            grown = (replay_call_t *)realloc(replay_calls, (size_t)capacity * sizeof(replay_call_t));
+            if (grown == NULL)
+            {
+                break;
+            }
+            replay_calls = grown;
+        }
+        if (replay_parse_call(&reader, &replay_calls[replay_total]) != 0)
+        {
+            UT_LOG("LPA_REPLAY : %s is truncated after %d calls", path, replay_total);
+            replay_free_call(&replay_calls[replay_total]);
+            break;
+        }
+        replay_count[replay_calls[replay_total].api]++;
+        replay_total++;
+    }
+    free(content.data);
+
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        replay_index[api] = (int *)calloc((size_t)(replay_count[api] + 1), sizeof(int));
+        replay_count[api] = 0;
+    }
+    for (i = 0; i < replay_total; i++)
+    {
+        api = replay_calls[i].api;
+        if (replay_index[api] != NULL)
+        {
+            replay_index[api][replay_count[api]++] = i;
+        }
+    }
+    UT_LOG("Replaying %d HAL calls from %s%s", replay_total, path, replay_fast ? " as fast as possible" : "");
+    return 0;
+}
+
+static void record_init(void)
+{
+    const char *record = getenv("LPA_RECORD");
+    const char *replay = getenv("LPA_REPLAY");
+    const char *fast = getenv("LPA_REPLAY_FAST");
+    record_buffer_t header;
+
+    if ((replay != NULL) && (*replay != '\0'))
+    {
+        replay_fast = (fast != NULL) && (strcmp(fast, "1") == 0);
+        if (replay_load(replay) != 0)
+        {
+            /* replaying nothing would test nothing */
+            exit(1);
+        }
+        replay_enabled = 1;
+    }
+    if ((record != NULL) && (*record != '\0'))
+    {
+        record_file = fopen(record, "wb");
+        if (record_file == NULL)
+        {
+            UT_LOG("LPA_RECORD : unable to create %s", record);
+            return;
+        }
+        memset(&header, 0, sizeof(header));
+        buffer_put(&header, LPA_RECORD_MAGIC, RECORD_MAGIC_LEN);
+        buffer_put_uint(&header, LPA_RECORD_VERSION, 4);
+        fwrite(header.data, 1, header.length, record_file);
+        free(header.data);
+        record_base_ns = lpa_perf_now_ns();
+    }
+}
+
+static void record_progress(int progress)
+{
+    uint64_t now = lpa_perf_now_ns();
+    cellular_sim_download_progress_callback forward = NULL;
+
+    pthread_mutex_lock(&record_lock);
+    if (record_progress_count < LPA_PROGRESS_MAX)
+    {
+        record_progress_value[record_progress_count] = progress;
+        record_progress_ns[record_progress_count] = now;
+        record_progress_count++;
+    }
+    forward = record_progress_forward;
+    pthread_mutex_unlock(&record_lock);
+    if (forward != NULL)
+    {
+        forward(progress);
+    }
+}
+
+cellular_sim_download_progress_callback lpa_record_progress_hook(cellular_sim_download_progress_callback progress)
+{
+    pthread_once(&record_once, record_init);
+    /* a NULL callback is part of what is tested, it is handed on unchanged */
+    if ((record_file == NULL) || (progress == NULL))
+    {
+        return progress;
+    }
+    pthread_mutex_lock(&record_lock);
+    record_progress_forward = progress;
+    record_progress_count = 0;
+    pthread_mutex_unlock(&record_lock);
+    return record_progress;
+}
+
+void lpa_record_call(const lpa_hal_call_t *call, const lpa_hal_params_t *params)
+{
+    record_buffer_t record;
+    eSIMProfileStruct *list = NULL;
+    int nb_profiles = -1;
+    int i = 0;
+
+    pthread_once(&record_once, record_init);
+    if (record_file == NULL)
+    {
+        return;
+    }
+    if ((call->result == RETURN_OK) && (params->profile_list != NULL) && (params->nb_profiles != NULL) &&
+        (*params->profile_list != NULL))
+    {
+        list = *params->profile_list;
+        nb_profiles = *params->nb_profiles;
+    }
+    memset(&record, 0, sizeof(record));
+    buffer_put_uint(&record, (uint64_t)call->api, 1);
+    buffer_put_uint(&record, (uint32_t)call->result, 4);
+    buffer_put_uint(&record, call->start_ns - record_base_ns, 8);
+    buffer_put_uint(&record, call->end_ns - call->start_ns, 8);
+    buffer_put_text(&record, params->text, RECORD_NULL_TEXT - 1, 2);
+    buffer_put_uint(&record, (uint32_t)params->size, 4);
+    buffer_put_uint(&record, (uint32_t)nb_profiles, 4);
+    for (i = 0; i < nb_profiles; i++)
+    {
+        buffer_put_text(&record, list[i].iccid, sizeof(list[i].iccid) < 255 ? sizeof(list[i].iccid) : 255, 1);
+        buffer_put_text(&record, list[i].profileName, sizeof(list[i].profileName) < 255 ? sizeof(list[i].profileName) : 255, 1);
+        buffer_put_uint(&record, (uint32_t)list[i].profileState, 4);
+    }
+
+    pthread_mutex_lock(&record_lock);
+    if ((params->progress != NULL) && (record_progress_forward == params->progress))
+    {
+        buffer_put_uint(&record, (uint64_t)record_progress_count, 2);
+        for (i = 0; i < record_progress_count; i++)
+        {
+            buffer_put_uint(&record, (uint32_t)record_progress_value[i], 4);
+            buffer_put_uint(&record, record_progress_ns[i] - call->start_ns, 8);
+        }
+        record_progress_forward = NULL;
+        record_progress_count = 0;
+    }
+    else
+    {
+        buffer_put_uint(&record, 0, 2);
+    }
+    if (record.failed == 0)
+    {
+        fwrite(record.data, 1, record.length, record_file);
+        record_count++;
+    }
+    pthread_mutex_unlock(&record_lock);
+    free(record.data);
+}
+
+int lpa_replay_enabled(void)
+{
+    pthread_once(&record_once, record_init);
+    return replay_enabled;
+}
+
+static int replay_same_argument(const replay_call_t *call, const lpa_hal_params_t *params)
+{
+    if ((call->text == NULL) || (params->text == NULL))
+    {
+        return (call->text == NULL) && (params->text == NULL);
+    }
+    return (strcmp(call->text, params->text) == 0) && (call->size == params->size);
+}
+
+/* Called with record_lock held */
+static const replay_call_t *replay_pick(lpa_api_t api, const lpa_hal_params_t *params)
+{
+    int count = replay_count[api];
+    int cursor = replay_cursor[api];
+    int i = 0;
+    int slot = 0;
+
+    if (count == 0)
+    {
+        return NULL;
+    }
+    for (i = 0; i < count; i++)
+    {
+        slot = (cursor + i) % count;
+        if (replay_same_argument(&replay_calls[replay_index[api][slot]], params))
+        {
+            break;
+        }
+    }
+    if (i == count)
+    {
+        slot = cursor;
+    }
+    replay_cursor[api] = (slot + 1) % count;
+    return &replay_calls[replay_index[api][slot]];
+}
+
+static void replay_sleep_until(uint64_t deadline_ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+}
+
+int lpa_replay_call(lpa_api_t api, const lpa_hal_params_t *params)
+{
+    uint64_t start = lpa_perf_now_ns();
+    const replay_call_t *call = NULL;
+    eSIMProfileStruct *list = NULL;
+    int i = 0;
+
+    pthread_mutex_lock(&record_lock);
+    call = replay_pick(api, params);
+    if (call == NULL)
+    {
+        replay_missed++;
+    }
+    else
+    {
+        replay_served++;
+    }
+    pthread_mutex_unlock(&record_lock);
+    if (call == NULL)
+    {
+        return RETURN_ERROR;
+    }
+    for (i = 0; i < call->nb_progress; i++)
+    {
+        if (replay_fast == 0)
+        {
+            replay_sleep_until(start + call->progress_offset_ns[i]);
+        }
+        if (params->progress != NULL)
+        {
+            params->progress(call->progress_value[i]);
+        }
+    }
+    if (replay_fast == 0)
+    {
+        replay_sleep_until(start + call->latency_ns);
+    }
+    if ((call->nb_profiles >= 0) && (params->profile_list != NULL) && (params->nb_profiles != NULL))
+    {
+        /* handed to the caller, who frees it like the library's list */
+        list = (eSIMProfileStruct *)calloc((size_t)(call->nb_profiles > 0 ? call->nb_profiles : 1), sizeof(eSIMProfileStruct));
+        if (list == NULL)
+        {
+            return RETURN_ERROR;
+        }
+        if (call->nb_profiles > 0)
+        {
+            memcpy(list, call->profiles, (size_t)call->nb_profiles * sizeof(eSIMProfileStruct));
+        }
+        *params->profile_list = list;
+        *params->nb_profiles = call->nb_profiles;
+    }
+    return call->result;
+}
+
+void lpa_record_report(void)
+{
+    const char *record = getenv("LPA_RECORD");
+    int i = 0;
+    int api = 0;
+
+    pthread_once(&record_once, record_init);
+    pthread_mutex_lock(&record_lock);
+    if (record_file != NULL)
+    {
+        fclose(record_file);
+        record_file = NULL;
+        UT_LOG("%llu HAL calls recorded to %s", (unsigned long long)record_count, record);
+    }
+    if (replay_enabled)
+    {
+        UT_LOG("%llu HAL calls replayed, %llu without a recorded call of their API",
+               (unsigned long long)replay_served, (unsigned long long)replay_missed);
+        for (i = 0; i < replay_total; i++)
+        {
+            replay_free_call(&replay_calls[i]);
+        }
+        free(replay_calls);
+        replay_calls = NULL;
+        replay_total = 0;
+        for (api = 0; api < LPA_API_MAX; api++)
+        {
+            free(replay_index[api]);
+            replay_index[api] = NULL;
+            replay_count[api] = 0;
+        }
+    }
+    pthread_mutex_unlock(&record_lock);
+}
+
+#endif /* LPA_HAL_WRAP */
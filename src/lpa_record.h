@@ -0,0 +1,69 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_record.h
+*
+* Record and replay of the HAL calls, part of `make HAL_WRAP=1`.
+*
+* - LPA_RECORD=<file> : typically on the device (TARGET=arm), every call into libesim_lpa is written
+*   to a binary trace: API, string argument, iccid size, return code, start and latency, the profile
+*   list returned by get_profile_info and the download progress callbacks with their timing.
+* - LPA_REPLAY=<file> : the calls are served from the trace instead of the library. Each call takes
+*   the next recorded call of the same API, preferring one with the same argument, and cycles when
+*   the trace is exhausted. The recorded latency and progress timing are reproduced, unless
+*   LPA_REPLAY_FAST=1 which answers as fast as possible.
+*
+* The trace is little endian whatever the host: the "LPATRACE" magic and a 32 bit version, then one
+* record per call:
+*
+*     u8 api, i32 result, u64 start_ns, u64 latency_ns,
+*     u16 argument length (0xffff for NULL), argument bytes, i32 iccid_size,
+*     i32 profile count (-1 without a list), per profile: u8 length, iccid, u8 length, profileName, i32 profileState,
+*     u16 progress count, per progress: i32 value, u64 offset_ns from the start of the call
+*/
+
+#ifndef LPA_RECORD_H
+#define LPA_RECORD_H
+
+#include "lpa_hal.h"
+#include "lpa_hal_wrap.h"
+
+#define LPA_RECORD_MAGIC    "LPATRACE"
+#define LPA_RECORD_VERSION  1
+
+/**
+ * @brief Callback to hand to the library: records the progress before forwarding it when recording
+ */
+cellular_sim_download_progress_callback lpa_record_progress_hook(cellular_sim_download_progress_callback progress);
+
+void lpa_record_call(const lpa_hal_call_t *call, const lpa_hal_params_t *params);
+
+/**
+ * @brief 1 when the calls are served from LPA_REPLAY
+ */
+int lpa_replay_enabled(void);
+
+/**
+ * @brief Serve one call from the trace, filling the outputs and invoking the progress callback
+ */
+int lpa_replay_call(lpa_api_t api, const lpa_hal_params_t *params);
+
+void lpa_record_report(void);
+
+#endif /* LPA_RECORD_H */
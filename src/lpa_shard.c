@@ -0,0 +1,346 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <CUnit/TestRun.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "lpa_shard.h"
+#include "lpa_perf.h"
+#ifdef LPA_HAL_WRAP
+#include "lpa_hal_wrap.h"
+#endif
+
+#define SHARD_DIR_DEFAULT  "/tmp/lpa_hal_shards"
+#define SHARD_PATH_MAX     512
+
+extern int test_lpa_hal_l1_register_group(lpa_shard_group_t group);
+
+const char *const lpa_shard_group_name[LPA_SHARD_GROUP_MAX] =
+{
+    "download_smds",
+    "download_defaultsmdp",
+    "download_activationcode",
+    "read",
+    "profile_state",
+    "lifecycle",
+};
+
+typedef struct
+{
+    pid_t pid;
+    int status;                 /* wait status */
+    uint64_t start_ns;
+    uint64_t end_ns;
+} shard_worker_t;
+
+/* Written by a worker, read by the runner once the worker has ended */
+typedef struct
+{
+    int done;                   /* the suite cleanup ran */
+    unsigned int tests_run;
+    unsigned int tests_failed;
+    unsigned int asserts_failed;
+} shard_tally_t;
+
+/* Shared with the workers, one entry per group */
+static shard_tally_t *shard_tally = NULL;
+static int shard_group = -1;
+
+int lpa_shard_parse_args(int *argc, char **argv, int *workers)
+{
+    int shard = 0;
+    int out = 1;
+    int in = 1;
+    char *end = NULL;
+    long value = 0;
+
+    *workers = 0;
+    for (in = 1; in < *argc; in++)
+    {
+        if (strcmp(argv[in], "--shards") != 0)
+        {
+            argv[out++] = argv[in];
+            continue;
+        }
+        if (in + 1 >= *argc)
+        {
+            printf("--shards needs a value\n");
+            return -1;
+        }
+        value = strtol(argv[++in], &end, 10);
+        /* more workers than groups is clamped by lpa_shard_run(), like the core count of --shards 0 */
+        if ((*end != '\0') || (end == argv[in]) || (value < 0) || (value > 0x7fffffffL))
+        {
+            printf("Invalid value for --shards : %s, 0 or more\n", argv[in]);
+            return -1;
+        }
+        *workers = (int)value;
+        shard = 1;
+    }
+    argv[out] = NULL;
+    *argc = out;
+    return shard;
+}
+
+static const char *shard_dir(void)
+{
+    const char *dir = getenv("LPA_SHARD_DIR");
+
+    return ((dir != NULL) && (*dir != '\0')) ? dir : SHARD_DIR_DEFAULT;
+}
+
+static int shard_mkdir(const char *path)
+{
+    if ((mkdir(path, 0755) != 0) && (errno != EEXIST))
+    {
+        printf("Unable to create %s : %s\n", path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+void lpa_shard_group_done(void)
+{
+    shard_tally_t *tally = NULL;
+
+    if ((shard_tally == NULL) || (shard_group < 0))
+    {
+        return;
+    }
+    tally = &shard_tally[shard_group];
+    tally->tests_run = CU_get_number_of_tests_run();
+    tally->tests_failed = CU_get_number_of_tests_failed();
+    tally->asserts_failed = CU_get_number_of_failures();
+    tally->done = 1;
+}
+
+/* Runs in the forked process, never returns */
+static void shard_worker(lpa_shard_group_t group, int argc, char **argv)
+{
+    char path[SHARD_PATH_MAX];
+    char slot[16];
+    int status = 1;
+    int fd = -1;
+
+    snprintf(path, sizeof(path), "%s/%s", shard_dir(), lpa_shard_group_name[group]);
+    if ((shard_mkdir(path) != 0) || (chdir(path) != 0))
+    {
+        _exit(1);
+    }
+    fd = open("output.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        _exit(1);
+    }
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+    snprintf(slot, sizeof(slot), "%d", (int)group);
+    setenv("LPA_SHARD", slot, 1);
+    shard_group = (int)group;
+
+    UT_init(argc, argv);
+    if (test_lpa_hal_l1_register_group(group) == 0)
+    {
+        /* a framework error, a suite that never reached its cleanup or any failed test fails the group */
+        status = (UT_run_tests() == UT_STATUS_OK) ? 0 : 1;
+        if (!shard_tally[group].done || (shard_tally[group].tests_failed > 0))
+        {
+            status = 1;
+        }
+    }
+#ifdef LPA_HAL_WRAP
+    if (lpa_hal_wrap_report() != 0)
+    {
+        status = 1;
+    }
+#endif
+    fflush(stdout);
+    fflush(stderr);
+    _exit(status);
+}
+
+static void shard_print_log(lpa_shard_group_t group)
+{
+    char path[SHARD_PATH_MAX];
+    char buffer[4096];
+    size_t length = 0;
+    FILE *file = NULL;
+
+    snprintf(path, sizeof(path), "%s/%s/output.log", shard_dir(), lpa_shard_group_name[group]);
+    printf("\n===== [L1 lpa_hal %s] %s =====\n", lpa_shard_group_name[group], path);
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("no output\n");
+        return;
+    }
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        fwrite(buffer, 1, length, stdout);
+    }
+    fclose(file);
+}
+
+static const char *shard_verdict(const shard_worker_t *worker, char *text, size_t size)
+{
+    if (WIFEXITED(worker->status))
+    {
+        return (WEXITSTATUS(worker->status) == 0) ? "passed" : "failed";
+    }
+    if (WIFSIGNALED(worker->status))
+    {
+        snprintf(text, size, "crashed, signal %d", WTERMSIG(worker->status));
+        return text;
+    }
+    return "unknown";
+}
+
+int lpa_shard_run(int workers, int argc, char **argv)
+{
+    shard_worker_t worker[LPA_SHARD_GROUP_MAX];
+    char text[32];
+    uint64_t start = 0;
+    uint64_t total = 0;
+    uint64_t busy = 0;
+    unsigned int tests_run = 0;
+    unsigned int tests_failed = 0;
+    unsigned int asserts_failed = 0;
+    int running = 0;
+    int next = 0;
+    int failed = 0;
+    int group = 0;
+    int status = 0;
+    pid_t pid = 0;
+
+    if (workers == 0)
+    {
+        workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (workers < 1)
+    {
+        workers = 1;
+    }
+    if (workers > LPA_SHARD_GROUP_MAX)
+    {
+        workers = LPA_SHARD_GROUP_MAX;
+    }
+    if (shard_mkdir(shard_dir()) != 0)
+    {
+        return 1;
+    }
+    shard_tally = (shard_tally_t *)mmap(NULL, LPA_SHARD_GROUP_MAX * sizeof(shard_tally_t), PROT_READ | PROT_WRITE,
+                                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shard_tally == MAP_FAILED)
+    {
+        shard_tally = NULL;
+        printf("Unable to share the results with the workers : %s\n", strerror(errno));
+        return 1;
+    }
+    memset(worker, 0, sizeof(worker));
+    printf("Running %d L1 groups on %d workers, logs in %s\n", LPA_SHARD_GROUP_MAX, workers, shard_dir());
+
+    start = lpa_perf_now_ns();
+    while ((next < LPA_SHARD_GROUP_MAX) || (running > 0))
+    {
+        if ((next < LPA_SHARD_GROUP_MAX) && (running < workers))
+        {
+            /* nothing buffered may be written twice by the child */
+            fflush(stdout);
+            fflush(stderr);
+            worker[next].start_ns = lpa_perf_now_ns();
+            pid = fork();
+            if (pid == 0)
+            {
+                shard_worker((lpa_shard_group_t)next, argc, argv);
+            }
+            if (pid < 0)
+            {
+                printf("fork failed for %s : %s\n", lpa_shard_group_name[next], strerror(errno));
+                worker[next].status = 1 << 8;
+                worker[next].end_ns = worker[next].start_ns;
+            }
+            else
+            {
+                worker[next].pid = pid;
+                running++;
+            }
+            next++;
+            continue;
+        }
+        pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        for (group = 0; group < LPA_SHARD_GROUP_MAX; group++)
+        {
+            if (worker[group].pid == pid)
+            {
+                worker[group].status = status;
+                worker[group].end_ns = lpa_perf_now_ns();
+                worker[group].pid = 0;
+                running--;
+            }
+        }
+    }
+    total = lpa_perf_now_ns() - start;
+
+    for (group = 0; group < LPA_SHARD_GROUP_MAX; group++)
+    {
+        shard_print_log((lpa_shard_group_t)group);
+    }
+    printf("\n%-28s %-20s %8s %8s %10s\n", "group", "result", "tests", "failed", "seconds");
+    for (group = 0; group < LPA_SHARD_GROUP_MAX; group++)
+    {
+        const char *verdict = shard_verdict(&worker[group], text, sizeof(text));
+        const shard_tally_t *tally = &shard_tally[group];
+
+        if (strcmp(verdict, "passed") != 0)
+        {
+            failed++;
+        }
+        tests_run += tally->tests_run;
+        tests_failed += tally->tests_failed;
+        asserts_failed += tally->asserts_failed;
+        busy += worker[group].end_ns - worker[group].start_ns;
+        printf("%-28s %-20s %8u %8u %10.2f\n", lpa_shard_group_name[group], verdict, tally->tests_run,
+               tally->tests_failed, (double)(worker[group].end_ns - worker[group].start_ns) / 1e9);
+    }
+    printf("%d of %d groups passed, %u tests run, %u failed (%u failed asserts)\n",
+           LPA_SHARD_GROUP_MAX - failed, LPA_SHARD_GROUP_MAX, tests_run, tests_failed, asserts_failed);
+    printf("wall %.2f s for %.2f s of tests (x%.2f)\n", (double)total / 1e9, (double)busy / 1e9,
+           (total > 0) ? (double)busy / (double)total : 0.0);
+    munmap(shard_tally, LPA_SHARD_GROUP_MAX * sizeof(shard_tally_t));
+    shard_tally = NULL;
+    return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_shard.h
+*
+* Sharded execution of the L1 suite, selected on the command line:
+*
+*     lpa_hal_test --shards <workers> [ut-core options]
+*
+* The L1 tests are partitioned in independent groups. Each group runs as its own suite
+* "[L1 lpa_hal <group>]" in a forked worker, at most <workers> at a time (0 for one per online CPU),
+* never more than there are groups. Forking gives every worker its own copy of the simulator state, and LPA_SHARD=<group index> is
+* set in the worker so the platform can select a device slot. A worker runs in
+* LPA_SHARD_DIR/<group> (default /tmp/lpa_hal_shards), where its output is logged to output.log next
+* to any result file written by ut-core. Once every worker has ended, the logs are printed in
+* group order followed by the status, tests run and failed and time of each group, and the totals.
+*
+* A group passes when its suite ran to its cleanup with no failed test. ut-core's UT_run_tests()
+* returns the framework error rather than the test failures, and clears the CUnit run summary before
+* returning, so the counts are taken by the group's suite cleanup (lpa_shard_group_done()) and
+* handed to the runner through memory shared with the workers.
+*/
+
+#ifndef LPA_SHARD_H
+#define LPA_SHARD_H
+
+typedef enum
+{
+    LPA_SHARD_DOWNLOAD_SMDS = 0,
+    LPA_SHARD_DOWNLOAD_DEFAULTSMDP,
+    LPA_SHARD_DOWNLOAD_ACTIVATIONCODE,
+    LPA_SHARD_READ,                     /* get_profile_info, get_eid, get_euicc */
+    LPA_SHARD_PROFILE_STATE,            /* enable, disable, delete */
+    LPA_SHARD_LIFECYCLE,                /* lpa_init, lpa_exit */
+    LPA_SHARD_GROUP_MAX
+} lpa_shard_group_t;
+
+extern const char *const lpa_shard_group_name[LPA_SHARD_GROUP_MAX];
+
+/**
+ * @brief Extract --shards from the command line
+ *
+ * @return 1 when sharding was requested, 0 when not, -1 on an invalid value (a message is printed)
+ */
+int lpa_shard_parse_args(int *argc, char **argv, int *workers);
+
+/**
+ * @brief Record the tests run and failed by the group of this worker
+ *
+ * To call from the cleanup of the group suite, while the CUnit run summary is still available.
+ * Does nothing outside a worker.
+ */
+void lpa_shard_group_done(void);
+
+/**
+ * @brief Run every group in a forked worker and merge the results
+ *
+ * argc / argv are handed to UT_init() in each worker.
+ *
+ * @return 0 when every worker passed, 1 otherwise
+ */
+int lpa_shard_run(int workers, int argc, char **argv);
+
+#endif /* LPA_SHARD_H */
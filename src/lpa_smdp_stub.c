@@ -0,0 +1,433 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "lpa_smdp_stub.h"
+#include "lpa_perf.h"
+
+#define STUB_REQUEST_MAX   (64 * 1024)
+#define STUB_CHUNK_MAX     4096
+#define STUB_IO_TIMEOUT_S  30
+
+typedef struct
+{
+    lpa_smdp_stub_t *stub;
+    int fd;
+} stub_connection_t;
+
+static void stub_sleep_ns(uint64_t ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        /* resume after EINTR */
+    }
+}
+
+static int stub_send_all(int fd, const char *data, size_t len)
+{
+    ssize_t sent = 0;
+
+    while (len > 0)
+    {
+        sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return 0;
+}
+
+/* Case insensitive search of a header line between `start` and `end` */
+static const char *stub_find_header(const char *start, const char *end, const char *name)
+{
+    size_t len = strlen(name);
+    const char *line = start;
+
+    while ((line != NULL) && (line + len <= end))
+    {
+        if (strncasecmp(line, name, len) == 0)
+        {
+            return line + len;
+        }
+        line = strstr(line, "\r\n");
+        line = (line != NULL) ? line + 2 : NULL;
+    }
+    return NULL;
+}
+
+/* Reads the request headers and the body announced by Content-Length, the content is not used */
+static int stub_read_request(int fd, char *buffer, size_t size)
+{
+    size_t used = 0;
+    size_t expected = 0;
+    ssize_t got = 0;
+    char *end = NULL;
+    const char *length = NULL;
+
+    while (used < size - 1)
+    {
+        got = recv(fd, buffer + used, size - 1 - used, 0);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            return -1;
+        }
+        used += (size_t)got;
+        buffer[used] = '\0';
+        if (end == NULL)
+        {
+            end = strstr(buffer, "\r\n\r\n");
+            if (end == NULL)
+            {
+                continue;
+            }
+            length = stub_find_header(buffer, end, "Content-Length:");
+            expected = (size_t)(end + 4 - buffer);
+            if (length != NULL)
+            {
+                expected += (size_t)strtoul(length, NULL, 10);
+            }
+        }
+        if (used >= expected)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Body shaped like an ES9+ / ES11 success answer, padded to the configured size */
+static char *stub_make_body(uint64_t request, long body_bytes, size_t *len)
+{
+    char head[160];
+    size_t head_len = 0;
+    size_t total = 0;
+    char *body = NULL;
+
+    head_len = (size_t)snprintf(head, sizeof(head),
+                                "{\"header\":{\"functionExecutionStatus\":{\"status\":\"Executed-Success\"}},\"transactionId\":\"%016llX\",\"serverSigned1\":\"",
+                                (unsigned long long)request);
+    total = head_len + 2;
+    if ((size_t)body_bytes > total)
+    {
+        total = (size_t)body_bytes;
+    }
+    body = (char *)malloc(total);
+    if (body == NULL)
+    {
+        return NULL;
+    }
+    memcpy(body, head, head_len);
+    memset(body + head_len, 'A', total - head_len - 2);
+    memcpy(body + total - 2, "\"}", 2);
+    *len = total;
+    return body;
+}
+
+/* Sends the body in chunks, sleeping so the average rate stays under `bandwidth` bytes per second */
+static int stub_send_paced(int fd, const char *body, size_t len, long bandwidth)
+{
+    uint64_t start = lpa_perf_now_ns();
+    uint64_t due = 0;
+    uint64_t now = 0;
+    size_t chunk = STUB_CHUNK_MAX;
+    size_t sent = 0;
+
+    if (bandwidth <= 0)
+    {
+        return stub_send_all(fd, body, len);
+    }
+    /* about 100 chunks per second at the capped rate */
+    if ((size_t)(bandwidth / 100) < chunk)
+    {
+        chunk = (bandwidth >= 100) ? (size_t)(bandwidth / 100) : 1;
+    }
+    while (sent < len)
+    {
+        size_t n = (len - sent < chunk) ? (len - sent) : chunk;
+
+        if (stub_send_all(fd, body + sent, n) != 0)
+        {
+            return -1;
+        }
+        sent += n;
+        due = start + (uint64_t)(((double)sent * 1e9) / (double)bandwidth);
+        now = lpa_perf_now_ns();
+        if (due > now)
+        {
+            stub_sleep_ns(due - now);
+        }
+    }
+    return 0;
+}
+
+static void stub_serve(lpa_smdp_stub_t *stub, int fd)
+{
+    lpa_smdp_stub_config_t config;
+    char *request = NULL;
+    char *body = NULL;
+    char header[256];
+    size_t body_len = 0;
+    uint64_t number = 0;
+    int fail = 0;
+
+    request = (char *)malloc(STUB_REQUEST_MAX);
+    if ((request == NULL) || (stub_read_request(fd, request, STUB_REQUEST_MAX) != 0))
+    {
+        free(request);
+        return;
+    }
+    free(request);
+
+    pthread_mutex_lock(&stub->lock);
+    config = stub->config;
+    number = stub->requests++;
+    /* fail error_percent of the requests, evenly spread over the sequence */
+    fail = ((number + 1) * (uint64_t)config.error_percent) / 100 != (number * (uint64_t)config.error_percent) / 100;
+    if (fail)
+    {
+        stub->errors++;
+    }
+    pthread_mutex_unlock(&stub->lock);
+
+    if (config.delay_us > 0)
+    {
+        stub_sleep_ns((uint64_t)config.delay_us * 1000ULL);
+    }
+    if (fail)
+    {
+        if (config.error_status > 0)
+        {
+            snprintf(header, sizeof(header), "HTTP/1.1 %d Injected Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", config.error_status);
+            stub_send_all(fd, header, strlen(header));
+        }
+        return;
+    }
+    body = stub_make_body(number, config.body_bytes, &body_len);
+    if (body == NULL)
+    {
+        return;
+    }
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 200 OK\r\nContent-Type: application/json;charset=UTF-8\r\nX-Admin-Protocol: gsma/rsp/v2.2.0\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+             body_len);
+    if (stub_send_all(fd, header, strlen(header)) == 0)
+    {
+        stub_send_paced(fd, body, body_len, config.bandwidth);
+    }
+    free(body);
+}
+
+static void *stub_connection_thread(void *arg)
+{
+    stub_connection_t *connection = (stub_connection_t *)arg;
+    lpa_smdp_stub_t *stub = connection->stub;
+
+    stub_serve(stub, connection->fd);
+    close(connection->fd);
+    free(connection);
+    pthread_mutex_lock(&stub->lock);
+    stub->active--;
+    pthread_cond_broadcast(&stub->idle);
+    pthread_mutex_unlock(&stub->lock);
+    return NULL;
+}
+
+static void *stub_accept_thread(void *arg)
+{
+    lpa_smdp_stub_t *stub = (lpa_smdp_stub_t *)arg;
+    stub_connection_t *connection = NULL;
+    struct timeval timeout = { STUB_IO_TIMEOUT_S, 0 };
+    pthread_attr_t attr;
+    pthread_t thread;
+    int one = 1;
+    int fd = -1;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (;;)
+    {
+        fd = accept(stub->listen_fd, NULL, NULL);
+        if (fd < 0)
+        {
+            if ((errno == EINTR) || (errno == ECONNABORTED))
+            {
+                continue;
+            }
+            break;
+        }
+        pthread_mutex_lock(&stub->lock);
+        if (stub->stopping)
+        {
+            pthread_mutex_unlock(&stub->lock);
+            close(fd);
+            break;
+        }
+        stub->active++;
+        pthread_mutex_unlock(&stub->lock);
+
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        connection = (stub_connection_t *)malloc(sizeof(stub_connection_t));
+        if (connection != NULL)
+        {
+            connection->stub = stub;
+            connection->fd = fd;
+            if (pthread_create(&thread, &attr, stub_connection_thread, connection) == 0)
+            {
+                continue;
+            }
+            free(connection);
+        }
+        close(fd);
+        pthread_mutex_lock(&stub->lock);
+        stub->active--;
+        pthread_cond_broadcast(&stub->idle);
+        pthread_mutex_unlock(&stub->lock);
+    }
+    pthread_attr_destroy(&attr);
+    return NULL;
+}
+
+static long stub_env_long(const char *name, long def)
+{
+    const char *value = getenv(name);
+    char *end = NULL;
+    long parsed = 0;
+
+    if ((value == NULL) || (*value == '\0'))
+    {
+        return def;
+    }
+    parsed = strtol(value, &end, 10);
+    return ((*end == '\0') && (parsed >= 0)) ? parsed : def;
+}
+
+void lpa_smdp_stub_default_config(lpa_smdp_stub_config_t *config)
+{
+    config->delay_us = stub_env_long("LPA_SMDP_STUB_DELAY_US", 0);
+    config->bandwidth = stub_env_long("LPA_SMDP_STUB_BANDWIDTH", 0);
+    config->body_bytes = stub_env_long("LPA_SMDP_STUB_BODY_BYTES", 2048);
+    config->error_percent = (int)stub_env_long("LPA_SMDP_STUB_ERROR_PERCENT", 0);
+    config->error_status = (int)stub_env_long("LPA_SMDP_STUB_ERROR_STATUS", 500);
+    if (config->error_percent > 100)
+    {
+        config->error_percent = 100;
+    }
+}
+
+int lpa_smdp_stub_start(lpa_smdp_stub_t *stub, int port, const lpa_smdp_stub_config_t *config)
+{
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    int one = 1;
+
+    memset(stub, 0, sizeof(*stub));
+    stub->config = *config;
+    stub->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (stub->listen_fd < 0)
+    {
+        return -1;
+    }
+    setsockopt(stub->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+    if ((bind(stub->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+        (listen(stub->listen_fd, 64) != 0) ||
+        (getsockname(stub->listen_fd, (struct sockaddr *)&addr, &addr_len) != 0))
+    {
+        close(stub->listen_fd);
+        stub->listen_fd = -1;
+        return -1;
+    }
+    stub->port = ntohs(addr.sin_port);
+    pthread_mutex_init(&stub->lock, NULL);
+    pthread_cond_init(&stub->idle, NULL);
+    if (pthread_create(&stub->thread, NULL, stub_accept_thread, stub) != 0)
+    {
+        pthread_mutex_destroy(&stub->lock);
+        pthread_cond_destroy(&stub->idle);
+        close(stub->listen_fd);
+        stub->listen_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void lpa_smdp_stub_configure(lpa_smdp_stub_t *stub, const lpa_smdp_stub_config_t *config)
+{
+    pthread_mutex_lock(&stub->lock);
+    stub->config = *config;
+    pthread_mutex_unlock(&stub->lock);
+}
+
+void lpa_smdp_stub_address(const lpa_smdp_stub_t *stub, char *address, size_t size)
+{
+    snprintf(address, size, "127.0.0.1:%d", stub->port);
+}
+
+void lpa_smdp_stub_stop(lpa_smdp_stub_t *stub)
+{
+    if (stub->listen_fd < 0)
+    {
+        return;
+    }
+    pthread_mutex_lock(&stub->lock);
+    stub->stopping = 1;
+    pthread_mutex_unlock(&stub->lock);
+    /* wakes accept() up */
+    shutdown(stub->listen_fd, SHUT_RDWR);
+    pthread_join(stub->thread, NULL);
+    close(stub->listen_fd);
+    stub->listen_fd = -1;
+    pthread_mutex_lock(&stub->lock);
+    while (stub->active > 0)
+    {
+        pthread_cond_wait(&stub->idle, &stub->lock);
+    }
+    pthread_mutex_unlock(&stub->lock);
+    pthread_mutex_destroy(&stub->lock);
+    pthread_cond_destroy(&stub->idle);
+}
@@ -0,0 +1,96 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_smdp_stub.h
+*
+* Loopback stand-in for the SM-DS / SM-DP+ servers.
+*
+* A small HTTP/1.1 server bound to 127.0.0.1 that answers every POST (the ES9+ / ES11 calls)
+* with a GSMA style "Executed-Success" json body, so the download APIs can be benchmarked without
+* internet access. Every connection is served by its own thread and closed after one exchange.
+*
+* The behaviour is adjustable at run time:
+* - delay_us : time waited before answering, the server side processing time
+* - bandwidth : response body throughput cap in bytes per second, 0 for unlimited
+* - body_bytes : size of the response body
+* - error_percent : share of requests failed, spread evenly so a run is reproducible
+* - error_status : HTTP status of a failed request, 0 closes the connection without answering
+*/
+
+#ifndef LPA_SMDP_STUB_H
+#define LPA_SMDP_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef struct
+{
+    long delay_us;
+    long bandwidth;
+    long body_bytes;
+    int error_percent;
+    int error_status;
+} lpa_smdp_stub_config_t;
+
+typedef struct
+{
+    int listen_fd;
+    int port;
+    int stopping;
+    int active;                 /* connections being served */
+    uint64_t requests;
+    uint64_t errors;
+    lpa_smdp_stub_config_t config;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t idle;
+} lpa_smdp_stub_t;
+
+/**
+ * @brief Default configuration, overridden by LPA_SMDP_STUB_DELAY_US, LPA_SMDP_STUB_BANDWIDTH,
+ * LPA_SMDP_STUB_BODY_BYTES, LPA_SMDP_STUB_ERROR_PERCENT and LPA_SMDP_STUB_ERROR_STATUS
+ */
+void lpa_smdp_stub_default_config(lpa_smdp_stub_config_t *config);
+
+/**
+ * @brief Listen on 127.0.0.1 and start serving
+ *
+ * @param port TCP port, 0 picks a free one
+ *
+ * @return 0 on success, -1 when the socket or the thread cannot be set up
+ */
+int lpa_smdp_stub_start(lpa_smdp_stub_t *stub, int port, const lpa_smdp_stub_config_t *config);
+
+/**
+ * @brief Change the behaviour for the following requests
+ */
+void lpa_smdp_stub_configure(lpa_smdp_stub_t *stub, const lpa_smdp_stub_config_t *config);
+
+/**
+ * @brief Write "127.0.0.1:<port>", the address to hand to the download APIs
+ */
+void lpa_smdp_stub_address(const lpa_smdp_stub_t *stub, char *address, size_t size);
+
+/**
+ * @brief Stop listening and wait for the connections in progress to complete
+ */
+void lpa_smdp_stub_stop(lpa_smdp_stub_t *stub);
+
+#endif /* LPA_SMDP_STUB_H */
@@ -0,0 +1,424 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "lpa_hal.h"
+#include "lpa_perf.h"
+#include "lpa_log.h"
+#include "lpa_soak.h"
+
+#define SOAK_ICCID_SIZE  20
+
+extern int num_iccid;
+extern char** iccid;
+extern int require_iccid(void);
+
+static const char *soak_op_name[LPA_SOAK_OP_MAX] =
+{
+    "get_profile_info",
+    "toggle",
+    "delete_invalid",
+    "get_eid",
+    "get_euicc",
+    "download_smds",
+    "download_defaultsmdp",
+    "download_activationcode",
+    "init_exit",
+};
+
+typedef struct
+{
+    long rss_kb;
+    int fds;
+    int threads;
+    uint64_t p50;
+    uint64_t p99;
+} soak_snapshot_t;
+
+static volatile sig_atomic_t soak_stop = 0;
+
+static void soak_on_signal(int sig)
+{
+    (void)sig;
+    soak_stop = 1;
+}
+
+static int soak_parse_mix(const char *spec, int weight[LPA_SOAK_OP_MAX])
+{
+    const char *p = spec;
+    int total = 0;
+    int op = 0;
+
+    memset(weight, 0, sizeof(int) * LPA_SOAK_OP_MAX);
+    while (*p != '\0')
+    {
+        const char *eq = strchr(p, '=');
+        size_t len = 0;
+        char *end = NULL;
+        long value = 0;
+
+        if (eq == NULL)
+        {
+            return -1;
+        }
+        len = (size_t)(eq - p);
+        for (op = 0; op < LPA_SOAK_OP_MAX; op++)
+        {
+            if ((strlen(soak_op_name[op]) == len) && (strncmp(soak_op_name[op], p, len) == 0))
+            {
+                break;
+            }
+        }
+        value = strtol(eq + 1, &end, 10);
+        if ((op == LPA_SOAK_OP_MAX) || (end == eq + 1) || (value < 0) || ((*end != ',') && (*end != '\0')))
+        {
+            return -1;
+        }
+        weight[op] = (int)value;
+        total += (int)value;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return (total > 0) ? 0 : -1;
+}
+
+static int soak_parse_positive(const char *text, long max, int *value)
+{
+    char *end = NULL;
+    long parsed = strtol(text, &end, 10);
+
+    if ((*end != '\0') || (parsed <= 0) || (parsed > max))
+    {
+        return -1;
+    }
+    *value = (int)parsed;
+    return 0;
+}
+
+int lpa_soak_parse_args(int *argc, char **argv, lpa_soak_config_t *config)
+{
+    int soak = 0;
+    int out = 1;
+    int in = 1;
+
+    config->duration_s = 0;
+    config->rate = 100;
+    config->interval_s = 60;
+    soak_parse_mix("get_profile_info=60,toggle=20,get_eid=10,get_euicc=10", config->weight);
+    for (in = 1; in < *argc; in++)
+    {
+        const char *option = argv[in];
+        int bad = 0;
+
+        if (strncmp(option, "--soak", strlen("--soak")) != 0)
+        {
+            argv[out++] = argv[in];
+            continue;
+        }
+        if (in + 1 >= *argc)
+        {
+            printf("%s needs a value\n", option);
+            return -1;
+        }
+        if (strcmp(option, "--soak") == 0)
+        {
+            bad = soak_parse_positive(argv[++in], 0x7fffffffL, &config->duration_s);
+            soak = 1;
+        }
+        else if (strcmp(option, "--soak-rate") == 0)
+        {
+            bad = soak_parse_positive(argv[++in], LPA_SOAK_MAX_RATE, &config->rate);
+        }
+        else if (strcmp(option, "--soak-interval") == 0)
+        {
+            bad = soak_parse_positive(argv[++in], 0x7fffffffL, &config->interval_s);
+        }
+        else if (strcmp(option, "--soak-mix") == 0)
+        {
+            bad = soak_parse_mix(argv[++in], config->weight);
+        }
+        else
+        {
+            printf("Unknown option %s\n", option);
+            return -1;
+        }
+        if (bad)
+        {
+            printf("Invalid value for %s : %s\n", option, argv[in]);
+            return -1;
+        }
+    }
+    argv[out] = NULL;
+    *argc = out;
+    return soak;
+}
+
+static char *soak_first_iccid(void)
+{
+    int i = 0;
+
+    if (require_iccid() != 0)
+    {
+        return NULL;
+    }
+    for (i = 0; i < num_iccid; i++)
+    {
+        if ((iccid[i] != NULL) && (iccid[i][0] != '\0'))
+        {
+            return iccid[i];
+        }
+    }
+    return NULL;
+}
+
+static void soak_progress(int progress)
+{
+    (void)progress;
+}
+
+/* Issues one operation, returns 0 when the HAL returned what the L1 suite expects */
+static int soak_invoke(lpa_soak_op_t op, char *profile)
+{
+    eSIMProfileStruct *profile_list = NULL;
+    int nb_profiles = 0;
+    int ok = 0;
+
+    switch (op)
+    {
+        case LPA_SOAK_GET_PROFILE_INFO:
+            ok = (cellular_esim_get_profile_info(&profile_list, &nb_profiles) == RETURN_OK);
+            free(profile_list);
+            break;
+        case LPA_SOAK_TOGGLE:
+            ok = (profile != NULL) &&
+                 (cellular_esim_enable_profile(profile, SOAK_ICCID_SIZE) == RETURN_OK) &&
+                 (cellular_esim_disable_profile(profile, SOAK_ICCID_SIZE) == RETURN_OK);
+            break;
+        case LPA_SOAK_DELETE_INVALID:
+            ok = (cellular_esim_delete_profile("98414102915071@#0054", SOAK_ICCID_SIZE) == RETURN_ERROR);
+            break;
+        case LPA_SOAK_GET_EID:
+            ok = (cellular_esim_get_eid() == RETURN_OK);
+            break;
+        case LPA_SOAK_GET_EUICC:
+            ok = (cellular_esim_get_euicc() == RETURN_OK);
+            break;
+        case LPA_SOAK_DOWNLOAD_SMDS:
+            ok = (cellular_esim_download_profile_from_smds("oem-smds-json.demo.gemalto.com") == RETURN_OK);
+            break;
+        case LPA_SOAK_DOWNLOAD_DEFAULTSMDP:
+            ok = (cellular_esim_download_profile_from_defaultsmdp("smdp-plus.test.gsma.com") == RETURN_OK);
+            break;
+        case LPA_SOAK_DOWNLOAD_ACTIVATIONCODE:
+            ok = (cellular_esim_download_profile_with_activationcode("1$smdp-plus.test.gsma.com$", soak_progress) == RETURN_OK);
+            break;
+        case LPA_SOAK_INIT_EXIT:
+            ok = (cellular_esim_lpa_exit() == RETURN_OK) && (cellular_esim_lpa_init() == RETURN_OK);
+            break;
+        default:
+            break;
+    }
+    return ok ? 0 : -1;
+}
+
+static lpa_soak_op_t soak_pick(const int weight[LPA_SOAK_OP_MAX], int total, uint64_t *seed)
+{
+    int draw = 0;
+    int op = 0;
+
+    /* xorshift64, fixed seed so runs are repeatable */
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 7;
+    *seed ^= *seed << 17;
+    draw = (int)(*seed % (uint64_t)total);
+    for (op = 0; op < LPA_SOAK_OP_MAX; op++)
+    {
+        if (draw < weight[op])
+        {
+            return (lpa_soak_op_t)op;
+        }
+        draw -= weight[op];
+    }
+    return LPA_SOAK_GET_PROFILE_INFO;
+}
+
+static void soak_sleep_until(uint64_t due)
+{
+    uint64_t now = lpa_perf_now_ns();
+    struct timespec ts;
+
+    if (due <= now)
+    {
+        return;
+    }
+    ts.tv_sec = (time_t)((due - now) / 1000000000ULL);
+    ts.tv_nsec = (long)((due - now) % 1000000000ULL);
+    nanosleep(&ts, NULL);
+}
+
+static void soak_snapshot(soak_snapshot_t *snap, const lpa_hist_t *window)
+{
+    snap->rss_kb = lpa_perf_rss_kb();
+    snap->fds = lpa_perf_fd_count();
+    snap->threads = lpa_perf_thread_count();
+    snap->p50 = lpa_hist_percentile(window, 50.0);
+    snap->p99 = lpa_hist_percentile(window, 99.0);
+}
+
+int lpa_soak_run(const lpa_soak_config_t *config)
+{
+    lpa_hist_t *window = NULL;
+    lpa_hist_t *op_hist = NULL;
+    soak_snapshot_t first;
+    soak_snapshot_t snap;
+    char *profile = soak_first_iccid();
+    uint64_t seed = 0x2545f4914f6cdd1dULL;
+    uint64_t interval_ns = (uint64_t)config->interval_s * 1000000000ULL;
+    uint64_t period_ns = 1000000000ULL / (uint64_t)config->rate;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint64_t next_snapshot = 0;
+    uint64_t due = 0;
+    uint64_t begin = 0;
+    uint64_t now = 0;
+    uint64_t lag = 0;
+    uint64_t max_lag = 0;
+    uint64_t ops = 0;
+    uint64_t errors = 0;
+    uint64_t window_errors = 0;
+    int op_errors[LPA_SOAK_OP_MAX];
+    void (*previous)(int) = SIG_DFL;
+    int total = 0;
+    int have_first = 0;
+    int op = 0;
+
+    memset(&first, 0, sizeof(first));
+    memset(&snap, 0, sizeof(snap));
+    for (op = 0; op < LPA_SOAK_OP_MAX; op++)
+    {
+        total += config->weight[op];
+        op_errors[op] = 0;
+    }
+    if ((config->weight[LPA_SOAK_TOGGLE] > 0) && (profile == NULL))
+    {
+        UT_LOG("soak: toggle needs an iccid in lpa_config");
+        return 1;
+    }
+    window = (lpa_hist_t *)malloc((LPA_SOAK_OP_MAX + 1) * sizeof(lpa_hist_t));
+    if (window == NULL)
+    {
+        UT_LOG("soak: histogram allocation failed");
+        return 1;
+    }
+    op_hist = window + 1;
+    lpa_hist_reset(window);
+    for (op = 0; op < LPA_SOAK_OP_MAX; op++)
+    {
+        lpa_hist_reset(&op_hist[op]);
+    }
+    if (lpa_perf_hal_init() != RETURN_OK)
+    {
+        UT_LOG("soak: cellular_esim_lpa_init failed");
+        free(window);
+        return 1;
+    }
+
+    UT_LOG("soak: %d s at %d ops/s, snapshot every %d s", config->duration_s, config->rate, config->interval_s);
+    for (op = 0; op < LPA_SOAK_OP_MAX; op++)
+    {
+        if (config->weight[op] > 0)
+        {
+            UT_LOG("soak: %-24s weight %d", soak_op_name[op], config->weight[op]);
+        }
+    }
+    /* the first line starts the log drain thread, before the first snapshot counts the threads */
+    LPA_LOG_INFO("%8s %10s %8s %10s %6s %8s %10s %10s %10s", "elapsed", "ops", "errors", "rss KiB", "fds", "threads", "p50 us", "p99 us", "lag ms");
+    previous = signal(SIGINT, soak_on_signal);
+    start = lpa_perf_now_ns();
+    end = start + (uint64_t)config->duration_s * 1000000000ULL;
+    next_snapshot = start + interval_ns;
+    due = start;
+    /* ends at the wall clock too, a rate the HAL cannot sustain must not stretch the run to drain the backlog */
+    while (!soak_stop && (due < end) && (lpa_perf_now_ns() < end))
+    {
+        /* open loop: operations are due on a fixed schedule, a slow call does not lower the rate */
+        soak_sleep_until(due);
+        begin = lpa_perf_now_ns();
+        lag = begin - due;
+        if (lag > max_lag)
+        {
+            max_lag = lag;
+        }
+        op = (int)soak_pick(config->weight, total, &seed);
+        if (soak_invoke((lpa_soak_op_t)op, profile) != 0)
+        {
+            errors++;
+            window_errors++;
+            op_errors[op]++;
+        }
+        now = lpa_perf_now_ns();
+        lpa_hist_record(window, now - begin);
+        lpa_hist_record(&op_hist[op], now - begin);
+        ops++;
+        due += period_ns;
+
+        if ((now >= next_snapshot) || (due >= end) || (now >= end))
+        {
+            soak_snapshot(&snap, window);
+            if (!have_first)
+            {
+                first = snap;
+                have_first = 1;
+            }
+            /* queued, the console write does not delay the next operations */
+            LPA_LOG_INFO("%8.0f %10llu %8llu %10ld %6d %8d %10.1f %10.1f %10.1f", (double)(lpa_perf_now_ns() - start) / 1e9,
+                         (unsigned long long)ops, (unsigned long long)window_errors, snap.rss_kb, snap.fds, snap.threads,
+                         (double)snap.p50 / 1e3, (double)snap.p99 / 1e3, (double)max_lag / 1e6);
+            lpa_hist_reset(window);
+            window_errors = 0;
+            max_lag = 0;
+            next_snapshot += interval_ns;
+        }
+    }
+    signal(SIGINT, previous);
+    lpa_log_flush();
+
+    lpa_hist_print_header("soak latency per operation");
+    for (op = 0; op < LPA_SOAK_OP_MAX; op++)
+    {
+        if (config->weight[op] > 0)
+        {
+            lpa_hist_print_row(soak_op_name[op], &op_hist[op], op_errors[op]);
+        }
+    }
+    if (have_first)
+    {
+        UT_LOG("soak drift first -> last snapshot: rss %+ld KiB, fds %+d, threads %+d, p99 %.1f -> %.1f us",
+               snap.rss_kb - first.rss_kb, snap.fds - first.fds, snap.threads - first.threads,
+               (double)first.p99 / 1e3, (double)snap.p99 / 1e3);
+    }
+    UT_LOG("soak: %llu operations, %llu errors%s", (unsigned long long)ops, (unsigned long long)errors, soak_stop ? ", interrupted" : "");
+    cellular_esim_lpa_exit();
+    free(window);
+    return (errors == 0) ? 0 : 1;
+}
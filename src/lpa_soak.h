@@ -0,0 +1,80 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_soak.h
+*
+* Long running soak mode, selected on the command line instead of the suites:
+*
+*     lpa_hal_test --soak <seconds> [--soak-rate <ops/s>] [--soak-interval <seconds>] [--soak-mix <mix>]
+*
+* The operations of the L1 suite are issued in a weighted random mix (fixed seed, so two runs issue the
+* same sequence) on an open loop schedule at the target rate. Every interval a snapshot row gives the
+* resident memory, open descriptors, threads, error count and latency percentiles of the interval,
+* and the run ends with the drift between the first and the last snapshot. Ctrl-C ends the run early.
+*
+* The mix is a list of operation=weight, the operations being get_profile_info, toggle (enable then
+* disable the first configured iccid), delete_invalid, get_eid, get_euicc, download_smds,
+* download_defaultsmdp, download_activationcode and init_exit.
+*/
+
+#ifndef LPA_SOAK_H
+#define LPA_SOAK_H
+
+/* One operation per nanosecond, the resolution of the schedule */
+#define LPA_SOAK_MAX_RATE 1000000000L
+
+typedef enum
+{
+    LPA_SOAK_GET_PROFILE_INFO = 0,
+    LPA_SOAK_TOGGLE,
+    LPA_SOAK_DELETE_INVALID,
+    LPA_SOAK_GET_EID,
+    LPA_SOAK_GET_EUICC,
+    LPA_SOAK_DOWNLOAD_SMDS,
+    LPA_SOAK_DOWNLOAD_DEFAULTSMDP,
+    LPA_SOAK_DOWNLOAD_ACTIVATIONCODE,
+    LPA_SOAK_INIT_EXIT,
+    LPA_SOAK_OP_MAX
+} lpa_soak_op_t;
+
+typedef struct
+{
+    int duration_s;
+    int rate;                           /* operations per second */
+    int interval_s;                     /* seconds between snapshots */
+    int weight[LPA_SOAK_OP_MAX];
+} lpa_soak_config_t;
+
+/**
+ * @brief Extract the --soak options from the command line
+ *
+ * Recognised options are removed from argv so the rest can be handed to UT_init().
+ *
+ * @return 1 when soak mode was requested, 0 when not, -1 on an invalid option (a message is printed)
+ */
+int lpa_soak_parse_args(int *argc, char **argv, lpa_soak_config_t *config);
+
+/**
+ * @brief Run the soak, the LPA is initialised at the start and released at the end
+ *
+ * @return 0 when every operation returned the expected result, 1 otherwise
+ */
+int lpa_soak_run(const lpa_soak_config_t *config);
+
+#endif /* LPA_SOAK_H */
@@ -0,0 +1,123 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lpa_synth.h"
+
+#define SYNTH_PREFIX        "890199"
+#define SYNTH_SERIAL_MOD    10000000000000ULL   /* 13 digits */
+#define SYNTH_SERIAL_STEP   7919ULL             /* prime to SYNTH_SERIAL_MOD, consecutive indexes do not share digits */
+
+const char *const lpa_synth_profile_name[3] = { "Xfinity Mobile", "Comcast", "CRTC" };
+
+void lpa_synth_iccid(int index, char text[LPA_ICCID_MAX_DIGITS + 1])
+{
+    unsigned long long serial = ((unsigned long long)index * SYNTH_SERIAL_STEP + 1ULL) % SYNTH_SERIAL_MOD;
+
+    snprintf(text, LPA_ICCID_MAX_DIGITS + 1, "%s%013llu", SYNTH_PREFIX, serial);
+    text[LPA_ICCID_MAX_DIGITS - 1] = lpa_iccid_check_digit(text, LPA_ICCID_MAX_DIGITS - 1);
+    text[LPA_ICCID_MAX_DIGITS] = '\0';
+}
+
+char *lpa_synth_sim_list(int count)
+{
+    char *list = (char *)malloc((size_t)count * (LPA_ICCID_MAX_DIGITS + 1) + 1);
+    char *p = list;
+    int i = 0;
+
+    if (list == NULL)
+    {
+        return NULL;
+    }
+    *p = '\0';
+    for (i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            *p++ = ',';
+        }
+        lpa_synth_iccid(i, p);
+        p += LPA_ICCID_MAX_DIGITS;
+    }
+    *p = '\0';
+    return list;
+}
+
+int lpa_synth_write_config(const char *path, int count)
+{
+    char text[LPA_ICCID_MAX_DIGITS + 1];
+    FILE *file = fopen(path, "w");
+    int i = 0;
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fprintf(file, "{\n  \"iccid\": [");
+    for (i = 0; i < count; i++)
+    {
+        lpa_synth_iccid(i, text);
+        fprintf(file, "%s\n    \"%s\"", (i > 0) ? "," : "", text);
+    }
+    fprintf(file, "\n  ],\n  \"profileName\": [\"%s\", \"%s\", \"%s\"]\n}\n",
+            lpa_synth_profile_name[0], lpa_synth_profile_name[1], lpa_synth_profile_name[2]);
+    if (fclose(file) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int lpa_synth_parse_args(int *argc, char **argv, int *count, const char **path)
+{
+    int requested = 0;
+    int out = 1;
+    int in = 1;
+    char *end = NULL;
+    long value = 0;
+
+    *count = 0;
+    *path = NULL;
+    for (in = 1; in < *argc; in++)
+    {
+        if (strcmp(argv[in], "--gen-config") != 0)
+        {
+            argv[out++] = argv[in];
+            continue;
+        }
+        if (in + 2 >= *argc)
+        {
+            printf("--gen-config needs a profile count and a file\n");
+            return -1;
+        }
+        value = strtol(argv[++in], &end, 10);
+        if ((*end != '\0') || (end == argv[in]) || (value < 1) || (value > LPA_SYNTH_MAX_PROFILES))
+        {
+            printf("Invalid profile count for --gen-config : %s, 1 to %d\n", argv[in], LPA_SYNTH_MAX_PROFILES);
+            return -1;
+        }
+        *count = (int)value;
+        *path = argv[++in];
+        requested = 1;
+    }
+    argv[out] = NULL;
+    *argc = out;
+    return requested;
+}
@@ -0,0 +1,66 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_synth.h
+*
+* Synthetic eUICC contents for the scaling runs: any number of distinct, valid iccids, written as an
+* lpa_config file or as the profile list of the eUICC simulator.
+*
+* `lpa_hal_test --gen-config <profiles> <file>` writes the lpa_config; running the suites with
+* LPA_SIM_CONFIG=<file> seeds the simulator with the same profiles. The performance suite sweep
+* (LPA_PERF_SCALE_SIZES) generates its sizes in process instead.
+*
+* Iccid i is "8901" "99", a 13 digit serial spread from i, and the Luhn check digit: 20 digits, all
+* distinct for i below 10^13.
+*/
+
+#ifndef LPA_SYNTH_H
+#define LPA_SYNTH_H
+
+#include "lpa_iccid.h"
+
+#define LPA_SYNTH_MAX_PROFILES  1000000
+
+/* Profile names of the simulator, which the generated lpa_config allows */
+extern const char *const lpa_synth_profile_name[3];
+
+void lpa_synth_iccid(int index, char text[LPA_ICCID_MAX_DIGITS + 1]);
+
+/**
+ * @brief Comma separated list of the first `count` iccids, the format of LPA_SIM_ICCIDS
+ *
+ * @return the list to free(), NULL on allocation failure
+ */
+char *lpa_synth_sim_list(int count);
+
+/**
+ * @brief Write an lpa_config with the first `count` iccids and the simulator profile names
+ *
+ * @return 0, -1 when the file cannot be written
+ */
+int lpa_synth_write_config(const char *path, int count);
+
+/**
+ * @brief Extract --gen-config <profiles> <file> from the command line
+ *
+ * @return 1 when a config was requested, 0 when not, -1 on an invalid value (a message is printed)
+ */
+int lpa_synth_parse_args(int *argc, char **argv, int *count, const char **path);
+
+#endif /* LPA_SYNTH_H */
@@ -0,0 +1,232 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifdef LPA_TRACE
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "lpa_trace.h"
+#include "lpa_perf.h"
+
+typedef struct
+{
+    uint64_t ts_ns;
+    const char *name;
+    const char *arg;
+    int64_t value;
+    int tid;
+    char phase;
+} trace_event_t;
+
+/*
+ * Written by its owner only; count is published after the event it covers. A buffer is owned by
+ * one thread at a time, and handed back when the thread exits or fills it, so a short-lived thread
+ * appends to the buffer a finished one left instead of mapping its own.
+ */
+typedef struct trace_buffer
+{
+    struct trace_buffer *next;
+    int owned;
+    uint32_t count;
+    uint32_t dropped;
+    trace_event_t event[];
+} trace_buffer_t;
+
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t trace_key;
+static uint32_t trace_capacity = 0;
+static uint64_t trace_origin_ns = 0;
+static trace_buffer_t *trace_buffers = NULL;
+static __thread trace_buffer_t *trace_local = NULL;
+static __thread uint32_t trace_written = 0;
+static __thread int trace_tid = 0;
+static __thread int trace_failed = 0;
+
+static void trace_dump(void);
+
+/* Run by the owner at its exit or once the buffer is full, the buffer can take the events of another thread */
+static void trace_release(void *arg)
+{
+    trace_local = NULL;
+    __atomic_store_n(&((trace_buffer_t *)arg)->owned, 0, __ATOMIC_RELEASE);
+}
+
+static void trace_init(void)
+{
+    trace_capacity = (uint32_t)lpa_perf_env_int("LPA_TRACE_EVENTS", LPA_TRACE_EVENTS_DEFAULT);
+    trace_origin_ns = lpa_perf_now_ns();
+    pthread_key_create(&trace_key, trace_release);
+    atexit(trace_dump);
+}
+
+/* A released buffer with room left, else a new one; mmap rather than malloc, the buffers stay out of the heap accounting */
+static trace_buffer_t *trace_buffer(void)
+{
+    trace_buffer_t *buffer = NULL;
+    size_t size = 0;
+    int owned = 0;
+
+    pthread_once(&trace_once, trace_init);
+    for (buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE); buffer != NULL; buffer = buffer->next)
+    {
+        owned = 0;
+        if ((__atomic_load_n(&buffer->owned, __ATOMIC_RELAXED) == 0) &&
+            __atomic_compare_exchange_n(&buffer->owned, &owned, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            if (buffer->count < trace_capacity)
+            {
+                return buffer;
+            }
+            __atomic_store_n(&buffer->owned, 0, __ATOMIC_RELEASE);
+        }
+    }
+    size = sizeof(trace_buffer_t) + (size_t)trace_capacity * sizeof(trace_event_t);
+    buffer = (trace_buffer_t *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+    {
+        trace_failed = 1;
+        return NULL;
+    }
+    buffer->owned = 1;
+    buffer->next = __atomic_load_n(&trace_buffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&trace_buffers, &buffer->next, buffer, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+    }
+    return buffer;
+}
+
+void lpa_trace_event(char phase, const char *name, const char *arg, int64_t value)
+{
+    trace_buffer_t *buffer = trace_local;
+    trace_event_t *event = NULL;
+    uint32_t count = 0;
+
+    if ((buffer != NULL) && (trace_written >= trace_capacity))
+    {
+        __atomic_store_n(&buffer->dropped, buffer->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if ((buffer == NULL) || (buffer->count >= trace_capacity))
+    {
+        if (trace_failed)
+        {
+            return;
+        }
+        if (buffer != NULL)
+        {
+            trace_release(buffer);
+        }
+        buffer = trace_local = trace_buffer();
+        if (buffer == NULL)
+        {
+            return;
+        }
+        pthread_setspecific(trace_key, buffer);
+        if (trace_tid == 0)
+        {
+            trace_tid = (int)syscall(SYS_gettid);
+        }
+    }
+    count = buffer->count;
+    event = &buffer->event[count];
+    event->ts_ns = lpa_perf_now_ns();
+    event->name = name;
+    event->arg = arg;
+    event->value = value;
+    event->tid = trace_tid;
+    event->phase = phase;
+    trace_written++;
+    __atomic_store_n(&buffer->count, count + 1, __ATOMIC_RELEASE);
+}
+
+static void trace_dump(void)
+{
+    const char *path = getenv("LPA_TRACE_FILE");
+    trace_buffer_t *buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE);
+    FILE *file = NULL;
+    uint64_t events = 0;
+    uint64_t dropped = 0;
+    uint64_t buffers = 0;
+    uint32_t count = 0;
+    uint32_t i = 0;
+    int pid = (int)getpid();
+    int tid = 0;
+
+    if ((path == NULL) || (*path == '\0'))
+    {
+        path = LPA_TRACE_FILE_DEFAULT;
+    }
+    file = fopen(path, "w");
+    if (file == NULL)
+    {
+        UT_LOG("Trace: cannot write %s", path);
+        return;
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"lpa_hal_test\"}}",
+            pid, pid);
+    for (; buffer != NULL; buffer = buffer->next)
+    {
+        count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+        tid = 0;
+        for (i = 0; i < count; i++)
+        {
+            const trace_event_t *event = &buffer->event[i];
+
+            /* the events of one thread are contiguous in a buffer, name it at its first one */
+            if (event->tid != tid)
+            {
+                tid = event->tid;
+                fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                        pid, tid, (tid == pid) ? "main" : "thread", tid);
+            }
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+                    event->name, event->phase, (double)(event->ts_ns - trace_origin_ns) / 1e3, pid, tid);
+            if (event->phase == 'i')
+            {
+                fprintf(file, ",\"s\":\"t\"");
+            }
+            if (event->arg != NULL)
+            {
+                fprintf(file, ",\"args\":{\"%s\":%lld}", event->arg, (long long)event->value);
+            }
+            fprintf(file, "}");
+        }
+        events += count;
+        dropped += __atomic_load_n(&buffer->dropped, __ATOMIC_RELAXED);
+        buffers++;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    UT_LOG("Trace: %llu events from %llu buffers written to %s", (unsigned long long)events,
+           (unsigned long long)buffers, path);
+    if (dropped > 0)
+    {
+        UT_LOG("Trace: %llu events dropped, raise LPA_TRACE_EVENTS above %u", (unsigned long long)dropped,
+               trace_capacity);
+    }
+}
+
+#endif /* LPA_TRACE */
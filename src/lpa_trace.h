@@ -0,0 +1,77 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_trace.h
+*
+* Timeline tracing, built with `make TRACE=1` (LPA_TRACE). Without it every macro below compiles
+* to nothing and LPA_TRACE_CALL() to the plain call.
+*
+* The L1 suite brackets each cellular_esim_* call with a begin and an end event carrying the return
+* code, the simulator adds its lock wait, latency, SM-DP+ exchange and progress callback spans, and
+* lpa_progress_callback() marks each progress received. Events go to a buffer owned by the calling
+* thread, appended without any lock; the buffer of a thread that exits is handed to the next new
+* thread, so short-lived threads do not map one each. The events are written at exit as Chrome
+* trace-event JSON to LPA_TRACE_FILE (default lpa_trace.json), to load in chrome://tracing or
+* https://ui.perfetto.dev.
+*
+* - LPA_TRACE_EVENTS : events kept per thread and capacity of each buffer, default 16384; the
+*   events a thread emits past it are dropped and counted
+*
+* Event and argument names are kept by pointer: pass string literals only.
+*/
+
+#ifndef LPA_TRACE_H
+#define LPA_TRACE_H
+
+#define LPA_TRACE_EVENTS_DEFAULT  16384
+#define LPA_TRACE_FILE_DEFAULT    "lpa_trace.json"
+
+#ifdef LPA_TRACE
+
+#include <stdint.h>
+
+/**
+ * @brief Append one event to the buffer of the calling thread
+ *
+ * @param phase 'B' begin, 'E' end or 'i' instant
+ * @param arg name of the integer argument, NULL for none
+ */
+void lpa_trace_event(char phase, const char *name, const char *arg, int64_t value);
+
+static inline int lpa_trace_result(const char *name, int result)
+{
+    lpa_trace_event('E', name, "result", result);
+    return result;
+}
+
+#define LPA_TRACE_BEGIN(name)               lpa_trace_event('B', (name), NULL, 0)
+#define LPA_TRACE_END(name)                 lpa_trace_event('E', (name), NULL, 0)
+#define LPA_TRACE_INSTANT(name, arg, value) lpa_trace_event('i', (name), (arg), (value))
+#define LPA_TRACE_CALL(api, ...)            (lpa_trace_event('B', #api, NULL, 0), lpa_trace_result(#api, api(__VA_ARGS__)))
+
+#else
+
+#define LPA_TRACE_BEGIN(name)               ((void)0)
+#define LPA_TRACE_END(name)                 ((void)0)
+#define LPA_TRACE_INSTANT(name, arg, value) ((void)0)
+#define LPA_TRACE_CALL(api, ...)            api(__VA_ARGS__)
+
+#endif /* LPA_TRACE */
+
+#endif /* LPA_TRACE_H */
@@ -0,0 +1,177 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "lpa_validate.h"
+
+static lpa_strset_t validate_iccids;
+static lpa_strset_t validate_names;
+
+/* FNV-1a, 64 bit */
+static uint64_t strset_hash(const char *key)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    while (*key != '\0')
+    {
+        hash ^= (unsigned char)*key++;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+int lpa_strset_init(lpa_strset_t *set, size_t expected)
+{
+    size_t capacity = 16;
+
+    /* keep the load factor at or below 1/2 */
+    while (capacity < expected * 2)
+    {
+        capacity <<= 1;
+    }
+    set->entries = (lpa_strset_entry_t *)calloc(capacity, sizeof(lpa_strset_entry_t));
+    if (set->entries == NULL)
+    {
+        set->mask = 0;
+        set->count = 0;
+        return -1;
+    }
+    set->mask = capacity - 1;
+    set->count = 0;
+    return 0;
+}
+
+/* Linear probe from the hash slot, returns the matching or the first empty entry */
+static lpa_strset_entry_t *strset_slot(const lpa_strset_t *set, const char *key, uint64_t hash)
+{
+    size_t i = (size_t)hash & set->mask;
+
+    while (set->entries[i].key != NULL)
+    {
+        if ((set->entries[i].hash == hash) && !strcmp(set->entries[i].key, key))
+        {
+            break;
+        }
+        i = (i + 1) & set->mask;
+    }
+    return &set->entries[i];
+}
+
+int lpa_strset_add(lpa_strset_t *set, const char *key)
+{
+    uint64_t hash = 0;
+    lpa_strset_entry_t *slot = NULL;
+
+    if ((set->entries == NULL) || (key == NULL))
+    {
+        return -1;
+    }
+    if ((set->count + 1) * 2 > set->mask + 1)
+    {
+        lpa_strset_t grown;
+        size_t i = 0;
+
+        if (lpa_strset_init(&grown, set->count + 1) != 0)
+        {
+            return -1;
+        }
+        for (i = 0; i <= set->mask; i++)
+        {
+            if (set->entries[i].key != NULL)
+            {
+                *strset_slot(&grown, set->entries[i].key, set->entries[i].hash) = set->entries[i];
+                grown.count++;
+            }
+        }
+        free(set->entries);
+        *set = grown;
+    }
+    hash = strset_hash(key);
+    slot = strset_slot(set, key, hash);
+    if (slot->key == NULL)
+    {
+        slot->hash = hash;
+        slot->key = key;
+        set->count++;
+    }
+    return 0;
+}
+
+bool lpa_strset_contains(const lpa_strset_t *set, const char *key)
+{
+    if ((set->entries == NULL) || (key == NULL))
+    {
+        return false;
+    }
+    return strset_slot(set, key, strset_hash(key))->key != NULL;
+}
+
+void lpa_strset_free(lpa_strset_t *set)
+{
+    free(set->entries);
+    set->entries = NULL;
+    set->mask = 0;
+    set->count = 0;
+}
+
+int lpa_validate_build(char **iccids, int nb_iccids, const char *const *names, int nb_names)
+{
+    int i = 0;
+
+    lpa_validate_free();
+    if ((lpa_strset_init(&validate_iccids, (size_t)nb_iccids) != 0) ||
+        (lpa_strset_init(&validate_names, (size_t)nb_names) != 0))
+    {
+        lpa_validate_free();
+        return -1;
+    }
+    for (i = 0; i < nb_iccids; i++)
+    {
+        if (lpa_strset_add(&validate_iccids, iccids[i]) != 0)
+        {
+            lpa_validate_free();
+            return -1;
+        }
+    }
+    for (i = 0; i < nb_names; i++)
+    {
+        if (lpa_strset_add(&validate_names, names[i]) != 0)
+        {
+            lpa_validate_free();
+            return -1;
+        }
+    }
+    return 0;
+}
+
+bool lpa_validate_iccid(const char *iccid)
+{
+    return lpa_strset_contains(&validate_iccids, iccid);
+}
+
+bool lpa_validate_profile_name(const char *name)
+{
+    return lpa_strset_contains(&validate_names, name);
+}
+
+void lpa_validate_free(void)
+{
+    lpa_strset_free(&validate_iccids);
+    lpa_strset_free(&validate_names);
+}
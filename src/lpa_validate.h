@@ -0,0 +1,66 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_validate.h
+*
+* Validation of the profiles returned by cellular_esim_get_profile_info against lpa_config.
+*
+* The configured iccids and allowed profile names are indexed once in open addressing hash
+* sets, so checking a profile list costs O(profiles) whatever the size of the configuration.
+* The sets only reference the strings, which must stay valid until lpa_validate_free().
+*/
+
+#ifndef LPA_VALIDATE_H
+#define LPA_VALIDATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t hash;
+    const char *key;
+} lpa_strset_entry_t;
+
+typedef struct
+{
+    lpa_strset_entry_t *entries;
+    size_t mask;
+    size_t count;
+} lpa_strset_t;
+
+int lpa_strset_init(lpa_strset_t *set, size_t expected);
+int lpa_strset_add(lpa_strset_t *set, const char *key);
+bool lpa_strset_contains(const lpa_strset_t *set, const char *key);
+void lpa_strset_free(lpa_strset_t *set);
+
+/**
+ * @brief Build the iccid and profile name indexes
+ *
+ * @return 0 on success, -1 on allocation failure
+ */
+int lpa_validate_build(char **iccids, int nb_iccids, const char *const *names, int nb_names);
+
+bool lpa_validate_iccid(const char *iccid);
+bool lpa_validate_profile_name(const char *name);
+
+void lpa_validate_free(void);
+
+#endif /* LPA_VALIDATE_H */
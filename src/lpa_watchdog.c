@@ -0,0 +1,271 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifdef LPA_HAL_WRAP
+
+#include <ut.h>
+#include <ut_log.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include "lpa_watchdog.h"
+#include "lpa_perf.h"
+
+/* One call handed to its thread, released by the last of the caller and the thread */
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int refs;
+    int done;
+    int abandoned;
+    lpa_api_t api;
+    lpa_hal_invoke_t invoke;
+    lpa_hal_params_t params;    /* private copies handed to the implementation */
+    eSIMProfileStruct *list;
+    int nb_profiles;
+    int result;
+    uint64_t start_ns;
+} watchdog_job_t;
+
+typedef struct
+{
+    uint64_t timeouts;
+    uint64_t late;              /* abandoned calls that returned afterwards */
+    uint64_t late_max_ns;       /* longest of them */
+} watchdog_stats_t;
+
+static pthread_once_t watchdog_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t watchdog_lock = PTHREAD_MUTEX_INITIALIZER;
+static int watchdog_ms = 0;
+static int watchdog_download_ms = 0;
+static watchdog_stats_t watchdog_stats[LPA_API_MAX];
+
+static void watchdog_init(void)
+{
+    watchdog_ms = lpa_perf_env_uint("LPA_WATCHDOG_MS", 0);
+    watchdog_download_ms = lpa_perf_env_int("LPA_WATCHDOG_DOWNLOAD_MS", LPA_WATCHDOG_DOWNLOAD_MS_DEFAULT);
+    if (watchdog_ms > 0)
+    {
+        UT_LOG("HAL watchdog: %d ms per call, %d ms per download", watchdog_ms, watchdog_download_ms);
+    }
+}
+
+static void watchdog_release(watchdog_job_t *job)
+{
+    int last = 0;
+
+    pthread_mutex_lock(&job->lock);
+    last = (--job->refs == 0);
+    pthread_mutex_unlock(&job->lock);
+    if (last)
+    {
+        pthread_cond_destroy(&job->cond);
+        pthread_mutex_destroy(&job->lock);
+        free(job->params.text);
+        free(job);
+    }
+}
+
+static void *watchdog_thread(void *arg)
+{
+    watchdog_job_t *job = (watchdog_job_t *)arg;
+    int result = job->invoke(job->api, &job->params);
+    uint64_t elapsed = 0;
+
+    pthread_mutex_lock(&job->lock);
+    job->result = result;
+    job->done = 1;
+    if (job->abandoned)
+    {
+        /* nobody takes the outputs any more */
+        if (result == RETURN_OK)
+        {
+            free(job->list);
+        }
+        elapsed = lpa_perf_now_ns() - job->start_ns;
+        pthread_mutex_lock(&watchdog_lock);
+        watchdog_stats[job->api].late++;
+        if (elapsed > watchdog_stats[job->api].late_max_ns)
+        {
+            watchdog_stats[job->api].late_max_ns = elapsed;
+        }
+        pthread_mutex_unlock(&watchdog_lock);
+    }
+    pthread_cond_signal(&job->cond);
+    pthread_mutex_unlock(&job->lock);
+    watchdog_release(job);
+    return NULL;
+}
+
+static watchdog_job_t *watchdog_job(lpa_api_t api, lpa_hal_invoke_t invoke, const lpa_hal_params_t *params)
+{
+    watchdog_job_t *job = (watchdog_job_t *)calloc(1, sizeof(watchdog_job_t));
+    pthread_condattr_t attr;
+
+    if (job == NULL)
+    {
+        return NULL;
+    }
+    job->refs = 2;
+    job->api = api;
+    job->invoke = invoke;
+    job->params = *params;
+    if (params->text != NULL)
+    {
+        job->params.text = strdup(params->text);
+        if (job->params.text == NULL)
+        {
+            free(job);
+            return NULL;
+        }
+    }
+    /* the outputs land in the job, NULL arguments stay NULL */
+    if (params->profile_list != NULL)
+    {
+        job->params.profile_list = &job->list;
+    }
+    if (params->nb_profiles != NULL)
+    {
+        job->params.nb_profiles = &job->nb_profiles;
+    }
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&job->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return job;
+}
+
+int lpa_watchdog_call(lpa_hal_call_t *call, lpa_hal_invoke_t invoke, const lpa_hal_params_t *params)
+{
+    watchdog_job_t *job = NULL;
+    pthread_attr_t attr;
+    pthread_t thread;
+    struct timespec deadline;
+    uint64_t deadline_ns = 0;
+    int limit_ms = 0;
+    int result = 0;
+
+    pthread_once(&watchdog_once, watchdog_init);
+    if (watchdog_ms <= 0)
+    {
+        return invoke(call->api, params);
+    }
+    limit_ms = ((call->api == LPA_API_DOWNLOAD_ACTIVATIONCODE) || (call->api == LPA_API_DOWNLOAD_SMDS) ||
+                (call->api == LPA_API_DOWNLOAD_DEFAULTSMDP)) ? watchdog_download_ms : watchdog_ms;
+    job = watchdog_job(call->api, invoke, params);
+    if (job == NULL)
+    {
+        return invoke(call->api, params);
+    }
+    job->start_ns = lpa_perf_now_ns();
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, watchdog_thread, job) != 0)
+    {
+        pthread_attr_destroy(&attr);
+        job->refs = 1;
+        watchdog_release(job);
+        return invoke(call->api, params);
+    }
+    pthread_attr_destroy(&attr);
+
+    deadline_ns = job->start_ns + (uint64_t)limit_ms * 1000000ULL;
+    deadline.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    deadline.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    pthread_mutex_lock(&job->lock);
+    while (job->done == 0)
+    {
+        if (pthread_cond_timedwait(&job->cond, &job->lock, &deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+    if (job->done)
+    {
+        result = job->result;
+        if (params->profile_list != NULL)
+        {
+            *params->profile_list = job->list;
+        }
+        if (params->nb_profiles != NULL)
+        {
+            *params->nb_profiles = job->nb_profiles;
+        }
+    }
+    else
+    {
+        job->abandoned = 1;
+        call->timed_out = 1;
+        result = RETURN_ERROR;
+    }
+    pthread_mutex_unlock(&job->lock);
+    if (call->timed_out)
+    {
+        pthread_mutex_lock(&watchdog_lock);
+        watchdog_stats[call->api].timeouts++;
+        pthread_mutex_unlock(&watchdog_lock);
+        UT_LOG("HAL watchdog: %s timed out after %.1f ms (deadline %d ms), the call is abandoned",
+               lpa_api_name[call->api], (double)(lpa_perf_now_ns() - job->start_ns) / 1e6, limit_ms);
+    }
+    watchdog_release(job);
+    return result;
+}
+
+void lpa_watchdog_report(void)
+{
+    watchdog_stats_t stats[LPA_API_MAX];
+    uint64_t total = 0;
+    int api = 0;
+
+    pthread_once(&watchdog_once, watchdog_init);
+    pthread_mutex_lock(&watchdog_lock);
+    memcpy(stats, watchdog_stats, sizeof(stats));
+    pthread_mutex_unlock(&watchdog_lock);
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        total += stats[api].timeouts;
+    }
+    if (total == 0)
+    {
+        if (watchdog_ms > 0)
+        {
+            UT_LOG("HAL watchdog: no call timed out");
+        }
+        return;
+    }
+    UT_LOG("HAL watchdog timeouts");
+    UT_LOG("%-52s %8s %12s %10s %16s", "api", "timeouts", "returned late", "still hung", "longest late ms");
+    for (api = 0; api < LPA_API_MAX; api++)
+    {
+        if (stats[api].timeouts == 0)
+        {
+            continue;
+        }
+        UT_LOG("%-52s %8llu %12llu %10llu %16.1f", lpa_api_name[api],
+               (unsigned long long)stats[api].timeouts,
+               (unsigned long long)stats[api].late,
+               (unsigned long long)(stats[api].timeouts - stats[api].late),
+               (double)stats[api].late_max_ns / 1e6);
+    }
+}
+
+#endif /* LPA_HAL_WRAP */
@@ -0,0 +1,51 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file lpa_watchdog.h
+*
+* Deadline per HAL call, part of `make HAL_WRAP=1` and enabled through the environment:
+* - LPA_WATCHDOG_MS : deadline of every call except the downloads
+* - LPA_WATCHDOG_DOWNLOAD_MS : deadline of the three downloads, default 5 minutes once the
+*   watchdog is enabled
+*
+* When enabled, each call runs on a thread of its own while the caller waits up to the deadline.
+* A call that overruns is abandoned: the caller gets RETURN_ERROR, the timeout is logged with the
+* elapsed time and the suite carries on. The abandoned thread keeps private copies of the
+* arguments, so its late return cannot touch the caller's memory. This costs a thread start per
+* call, leave it off for the performance suites. The heap accounting follows the call onto its
+* thread, the job and the thread start are not charged to the API.
+*/
+
+#ifndef LPA_WATCHDOG_H
+#define LPA_WATCHDOG_H
+
+#include "lpa_hal_wrap.h"
+
+#define LPA_WATCHDOG_DOWNLOAD_MS_DEFAULT  300000
+
+/**
+ * @brief Invoke the call, under the deadline when the watchdog is enabled
+ *
+ * @return the result of the call, RETURN_ERROR with call->timed_out set on a timeout
+ */
+int lpa_watchdog_call(lpa_hal_call_t *call, lpa_hal_invoke_t invoke, const lpa_hal_params_t *params);
+
+void lpa_watchdog_report(void);
+
+#endif /* LPA_WATCHDOG_H */
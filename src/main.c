@@ -19,29 +19,71 @@
 #include <ut_log.h>
 #include <stdlib.h>
 #include "lpa_hal.h"
+#include "lpa_soak.h"
+#include "lpa_shard.h"
+#include "lpa_synth.h"
+#ifdef LPA_HAL_WRAP
+#include "lpa_hal_wrap.h"
+#endif
 
-extern int get_iccid(void);
 extern int register_hal_l1_tests( void );
 extern void freeiccid(void);
-
-extern int num_iccid;
-extern char** iccid;
+extern int require_iccid(void);
 
 int main(int argc, char** argv)
 {
     int registerReturn = 0;
+    lpa_soak_config_t soakConfig;
+    int soak = 0;
+    int shardWorkers = 0;
+    int shard = 0;
+    int genProfiles = 0;
+    const char *genPath = NULL;
+    int gen = 0;
 
-    if(get_iccid() == 0)
+    /* --gen-config <profiles> <file> writes a synthetic lpa_config and exits, no config needed */
+    gen = lpa_synth_parse_args(&argc, argv, &genProfiles, &genPath);
+    if (gen != 0)
     {
-        UT_LOG("Got the iccid values :\n");
-        for (int i = 0;i < num_iccid; i++)
+        if ((gen > 0) && (lpa_synth_write_config(genPath, genProfiles) == 0))
+        {
+            printf("%d profiles written to %s, run with LPA_SIM_CONFIG=%s to seed the simulator with them\n",
+                   genProfiles, genPath, genPath);
+            return 0;
+        }
+        if (gen > 0)
         {
-            UT_LOG("iccid[%d] : %s \n", i+1,iccid[i]);
+            printf("Cannot write %s\n", genPath);
         }
+        return 1;
     }
-    else
+    /* lpa_config is loaded by the first test that needs iccids, see require_iccid() */
+    /* --soak <seconds> runs the soak mode instead of the suites */
+    soak = lpa_soak_parse_args(&argc, argv, &soakConfig);
+    if (soak != 0)
     {
-        UT_LOG("Failed to get iccid value\n");
+        registerReturn = (soak > 0) ? lpa_soak_run(&soakConfig) : 1;
+#ifdef LPA_HAL_WRAP
+        if (lpa_hal_wrap_report() != 0)
+        {
+            registerReturn = 1;
+        }
+#endif
+        freeiccid();
+        return registerReturn;
+    }
+    /* --shards <workers> runs the L1 groups in forked workers instead of a single suite */
+    shard = lpa_shard_parse_args(&argc, argv, &shardWorkers);
+    if (shard != 0)
+    {
+        /* the workers change directory, they inherit lpa_config loaded (or not found) from here */
+        if (shard > 0)
+        {
+            (void)require_iccid();
+        }
+        registerReturn = (shard > 0) ? lpa_shard_run(shardWorkers, argc, argv) : 1;
+        freeiccid();
+        return registerReturn;
     }
     /* Register tests as required, then call the UT-main to support switches and triggering */
     UT_init( argc, argv );
@@ -58,8 +100,12 @@ int main(int argc, char** argv)
     }
     /* Begin test executions */
     UT_run_tests();
+#ifdef LPA_HAL_WRAP
+    /* a baseline regression fails the run */
+    registerReturn = lpa_hal_wrap_report();
+#endif
 
     freeiccid();
 
-    return 0;
+    return registerReturn;
 }
\ No newline at end of file
@@ -34,154 +34,348 @@
 #include <ut_log.h>
 #include "lpa_hal.h"
 #include <stdlib.h>
-#include "cJSON.h"
 #include <string.h>
 #include <ctype.h>
 #include<stdbool.h>
+#include "lpa_validate.h"
+#include "lpa_config.h"
+#include "lpa_config_cache.h"
+#include "lpa_iccid.h"
+#include "lpa_arena.h"
+#include "lpa_perf.h"
+#include "lpa_log.h"
+#include "lpa_shard.h"
+#include "lpa_trace.h"
+
+#ifdef LPA_TRACE
+/* Every HAL call of the suite is traced with its return code, see lpa_trace.h */
+#define cellular_esim_download_profile_with_activationcode(...) LPA_TRACE_CALL(cellular_esim_download_profile_with_activationcode, ##__VA_ARGS__)
+#define cellular_esim_download_profile_from_smds(...) LPA_TRACE_CALL(cellular_esim_download_profile_from_smds, ##__VA_ARGS__)
+#define cellular_esim_download_profile_from_defaultsmdp(...) LPA_TRACE_CALL(cellular_esim_download_profile_from_defaultsmdp, ##__VA_ARGS__)
+#define cellular_esim_get_profile_info(...) LPA_TRACE_CALL(cellular_esim_get_profile_info, ##__VA_ARGS__)
+#define cellular_esim_enable_profile(...) LPA_TRACE_CALL(cellular_esim_enable_profile, ##__VA_ARGS__)
+#define cellular_esim_disable_profile(...) LPA_TRACE_CALL(cellular_esim_disable_profile, ##__VA_ARGS__)
+#define cellular_esim_delete_profile(...) LPA_TRACE_CALL(cellular_esim_delete_profile, ##__VA_ARGS__)
+#define cellular_esim_lpa_init(...) LPA_TRACE_CALL(cellular_esim_lpa_init, ##__VA_ARGS__)
+#define cellular_esim_lpa_exit(...) LPA_TRACE_CALL(cellular_esim_lpa_exit, ##__VA_ARGS__)
+#define cellular_esim_get_eid(...) LPA_TRACE_CALL(cellular_esim_get_eid, ##__VA_ARGS__)
+#define cellular_esim_get_euicc(...) LPA_TRACE_CALL(cellular_esim_get_euicc, ##__VA_ARGS__)
+#endif
+
+/* Longest wait for a download to report 100 percent once the API returned */
+#define DOWNLOAD_PROGRESS_TIMEOUT_MS  60000
 
 char** iccid = NULL;
 int num_iccid = 0;
 
-/**function to read the json config file and return its content as a string
- *IN : json file name
- *OUT : content of json file as string
+/* Profile names accepted when lpa_config has no "profileName" list */
+static const char *default_profile_name[] = { "Xfinity Mobile", "Comcast", "CRTC" };
+
+char** profile_name = NULL;
+int num_profile_name = 0;
+
+/* iccid and profile_name tables and strings, released together by freeiccid() */
+static lpa_arena_t config_arena;
+/* compiled lpa_config, iccid and profile_name point into it when it was current */
+static lpa_config_cache_t config_cache;
+/* lpa_config load state: 0 not loaded yet, 1 loaded, -1 failed (not retried until freeiccid()) */
+static int config_state = 0;
+
+typedef struct
+{
+    int iccid_capacity;
+    int profile_name_capacity;
+} config_tables_t;
+
+/**function to append a string of the config to a pointer table
+ *IN : table, its size and capacity, string view inside the mapping
+ *OUT : 0 on success, the string and the table live in config_arena
  **/
-static char *read_file(const char *filename)
+static int append_string(char ***array, int *count, int *capacity, lpa_strview_t value)
 {
-    FILE *file = NULL;
-    long length = 0;
-    char *content = NULL;
-    size_t read_chars = 0;
-
-    /* open in read mode */
-    file = fopen(filename, "r");
-    if (file == NULL)
+    char **grown = NULL;
+
+    if (*count == *capacity)
     {
-        printf("Please place lpa_config file ,where your binary is placed\n");
-        exit(1);
+        /* the table doubles, outgrown copies stay in the arena until freeiccid() */
+        *capacity = (*capacity == 0) ? 16 : (*capacity * 2);
+        grown = (char **)lpa_arena_alloc(&config_arena, (size_t)*capacity * sizeof(char *));
+        if (grown == NULL)
+        {
+            printf("Memory allocation failed\n");
+            return -1;
+        }
+        if (*count > 0)
+        {
+            memcpy(grown, *array, (size_t)*count * sizeof(char *));
+        }
+        *array = grown;
     }
-    else
+    (*array)[*count] = lpa_arena_strndup(&config_arena, value.ptr, value.len);
+    if ((*array)[*count] == NULL)
+    {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    (*count)++;
+    return 0;
+}
+
+/* lpa_config_parse() callback, collects the "iccid" and the optional "profileName" arrays */
+static int collect_config_string(void *ctx, lpa_strview_t key, int index, lpa_strview_t value)
+{
+    config_tables_t *tables = (config_tables_t *)ctx;
+
+    if (index < 0)
+    {
+        return 0;
+    }
+    if (strcmp(key.ptr, "iccid") == 0)
     {
-        /* get the length */
-        if (fseek(file, 0, SEEK_END) == 0)
+        return append_string(&iccid, &num_iccid, &tables->iccid_capacity, value);
+    }
+    if (strcmp(key.ptr, "profileName") == 0)
+    {
+        return append_string(&profile_name, &num_profile_name, &tables->profile_name_capacity, value);
+    }
+    return 0;
+}
+
+/* Free memory allocated for iccid */
+void freeiccid(void)
+{
+    lpa_validate_free();
+    lpa_arena_destroy(&config_arena);
+    lpa_config_cache_close(&config_cache);
+    iccid = NULL;
+    num_iccid = 0;
+    profile_name = NULL;
+    num_profile_name = 0;
+    config_state = 0;
+}
+
+
+/**function to point iccid and profile_name at the slots of the mapped cache
+ *OUT : 0 on success, only the pointer tables are allocated, in config_arena
+ **/
+static int use_config_cache(void)
+{
+    uint32_t i = 0;
+
+    num_iccid = (int)config_cache.header->nb_iccid;
+    num_profile_name = (int)config_cache.header->nb_profile_name;
+    if (num_iccid > 0)
+    {
+        iccid = (char **)lpa_arena_alloc(&config_arena, (size_t)num_iccid * sizeof(char *));
+        if (iccid == NULL)
         {
-            length = ftell(file);
-            if (length > 0)
-            {
-                if (fseek(file, 0, SEEK_SET) == 0)
-                {
-                    /* allocate content buffer */
-                    content = (char *)malloc((size_t)length + sizeof(""));
-                    if (content != NULL)
-                    {
-                        /* read the file into memory */
-                        read_chars = fread(content, sizeof(char), (size_t)length, file);
-                        if ((long)read_chars != length)
-                        {
-                            free(content);
-                            content = NULL;
-                        }
-                        else
-                            content[read_chars] = '\0';
-                    }
-                }
-            }
-            else
-            {
-                printf("lpa_config file is empty. please add configuration\n");
-                exit(1);
-            }
+            return -1;
+        }
+    }
+    if (num_profile_name > 0)
+    {
+        profile_name = (char **)lpa_arena_alloc(&config_arena, (size_t)num_profile_name * sizeof(char *));
+        if (profile_name == NULL)
+        {
+            return -1;
         }
-        fclose(file);
     }
-    return content;
+    // The mapping is private, a HAL writing to the iccid it is given only changes this process' copy
+    for (i = 0; i < (uint32_t)num_iccid; i++)
+    {
+        iccid[i] = (char *)lpa_config_cache_iccid(&config_cache, i);
+    }
+    for (i = 0; i < (uint32_t)num_profile_name; i++)
+    {
+        profile_name[i] = (char *)lpa_config_cache_name(&config_cache, i);
+    }
+    UT_LOG("lpa_config mapped from %s", lpa_config_cache_path());
+    return 0;
 }
 
-/**function to read the json config file and return its content as a json object
- *IN : json file name
- *OUT : content of json file as a json object
+/**function to parse lpa_config and compile it to the cache
+ *IN : config path, cache path (NULL when caching is disabled), size and mtime of the config
+ *OUT : 0 on success
  **/
-static cJSON *parse_file(const char *filename)
+static int parse_config(const char *configFile, const char *cachePath, lpa_config_source_t *source)
 {
-    cJSON *parsed = NULL;
-    char *content = read_file(filename);
-    parsed = cJSON_Parse(content);
+    lpa_config_t config;
+    config_tables_t tables = { 0, 0 };
+    lpa_config_status_t status = LPA_CONFIG_OK;
 
-    if (content != NULL)
+    if (lpa_config_open(&config, configFile) != LPA_CONFIG_OK)
+    {
+        printf("Failed to parse config\n");
+        return -1;
+    }
+    // Only the mtime changed: a cache holding the same text is used after all
+    if ((cachePath != NULL) && (lpa_config_cache_open(&config_cache, cachePath, source, &config) == 0))
     {
-        free(content);
+        lpa_config_close(&config);
+        return use_config_cache();
     }
-
-    return parsed;
+    // Single pass over the mapping, the strings are copied into config_arena and the file unmapped
+    status = lpa_config_parse(&config, collect_config_string, &tables);
+    lpa_config_close(&config);
+    if (status != LPA_CONFIG_OK)
+    {
+        printf("Failed to parse config\n");
+        return -1;
+    }
+    if (cachePath != NULL)
+    {
+        if (lpa_config_cache_write(cachePath, source, iccid, num_iccid, profile_name, num_profile_name) == 0)
+        {
+            UT_LOG("lpa_config compiled to %s", cachePath);
+        }
+        else
+        {
+            UT_LOG("lpa_config could not be compiled to %s, it is parsed on every start", cachePath);
+        }
+    }
+    return 0;
 }
 
-/* Free memory allocated for iccid */
-void freeiccid(void)
+/**function to check digits, length and check digit of the configured iccids in one pass
+ *A mapped cache already holds them in LPA_ICCID_SLOT wide slots, parsed ones are copied into a slot table.
+ *Empty iccids mean "not configured" and are not reported.
+ *OUT : number of invalid iccids, they are only logged, the HAL decides whether it accepts them
+ **/
+static int check_config_iccids(void)
 {
+    static const char *const reason[] = { "valid", "length", "digit", "check digit" };
+    const char *slots = NULL;
+    char *copy = NULL;
+    uint8_t *status = NULL;
+    size_t stride = LPA_ICCID_SLOT;
+    int invalid = 0;
     int i = 0;
-    if (iccid != NULL)
+
+    if (num_iccid == 0)
+    {
+        return 0;
+    }
+    status = (uint8_t *)malloc((size_t)num_iccid);
+    if (status == NULL)
+    {
+        return 0;
+    }
+    if (config_cache.header != NULL)
+    {
+        slots = lpa_config_cache_iccid(&config_cache, 0);
+        stride = config_cache.header->iccid_width;
+    }
+    else
     {
+        copy = (char *)calloc((size_t)num_iccid, LPA_ICCID_SLOT);
+        if (copy == NULL)
+        {
+            free(status);
+            return 0;
+        }
         for (i = 0; i < num_iccid; i++)
         {
-            free(iccid[i]);
+            /* too long for a slot: cut, lpa_iccid_check_slots still reports a bad length */
+            strncpy(copy + (size_t)i * LPA_ICCID_SLOT, iccid[i], LPA_ICCID_SLOT - 1);
         }
-        free(iccid);
+        slots = copy;
     }
+    lpa_iccid_check_slots(slots, (size_t)num_iccid, stride, status);
+    for (i = 0; i < num_iccid; i++)
+    {
+        if ((status[i] != LPA_ICCID_OK) && (iccid[i][0] != '\0'))
+        {
+            UT_LOG("iccid[%d] : %s is not a valid ICCID (bad %s)", i + 1, iccid[i], reason[status[i]]);
+            invalid++;
+        }
+    }
+    free(copy);
+    free(status);
+    return invalid;
 }
 
-
 int get_iccid(void)
 {
     char configFile[] = "./lpa_config";
-    cJSON *value = NULL;
-    cJSON *json = NULL;
-    cJSON *item = NULL;
-    int i = 0;
+    const char *cachePath = lpa_config_cache_path();
+    lpa_config_source_t source;
+    lpa_config_status_t status = LPA_CONFIG_OK;
+    int ret = 0;
 
     UT_LOG("Checking iccid...  \n");
-    json = parse_file(configFile);
-    if (json == NULL)
+    freeiccid();
+    lpa_arena_init(&config_arena, 0);
+    status = lpa_config_cache_source(configFile, &source);
+    if (status == LPA_CONFIG_ERR_OPEN)
     {
-        printf("Failed to parse config\n");
+        printf("Please place lpa_config file ,where your binary is placed\n");
+        freeiccid();
+        return -1;
+    }
+    if (status == LPA_CONFIG_ERR_EMPTY)
+    {
+        printf("lpa_config file is empty. please add configuration\n");
+        freeiccid();
+        return -1;
+    }
+    // A cache compiled from this lpa_config is mapped without reading the json
+    if ((cachePath != NULL) && (lpa_config_cache_open(&config_cache, cachePath, &source, NULL) == 0))
+    {
+        ret = use_config_cache();
+    }
+    else
+    {
+        ret = parse_config(configFile, cachePath, &source);
+    }
+    if (ret != 0)
+    {
+        freeiccid();
+        return -1;
+    }
+    printf("Number of iccid : %d \n", num_iccid);
+    if (check_config_iccids() > 0)
+    {
+        UT_LOG("lpa_config lists invalid iccids, the tests using them expect the HAL to accept them");
+    }
+    // Index iccids and profile names once, so validating a profile list stays linear
+    if (num_profile_name > 0)
+    {
+        ret = lpa_validate_build(iccid, num_iccid, (const char *const *)profile_name, num_profile_name);
+    }
+    else
+    {
+        ret = lpa_validate_build(iccid, num_iccid, default_profile_name, (int)(sizeof(default_profile_name) / sizeof(default_profile_name[0])));
+    }
+    if (ret != 0)
+    {
+        printf("Memory allocation failed\n");
+        freeiccid();
         return -1;
     }
-    value = cJSON_GetObjectItem(json, "iccid");
-    // null check and object is Array, value->valuestring
-    if ((value != NULL) && (cJSON_IsArray(value)))
+    UT_LOG("Got the iccid values :\n");
+    for (int i = 0;i < num_iccid; i++)
     {
-        num_iccid = cJSON_GetArraySize(value);
-        printf("Number of iccid : %d \n", num_iccid);
+        UT_LOG("iccid[%d] : %s \n", i+1,iccid[i]);
+    }
+    return 0;
+}
 
-        // Allocate memory for iccid
-        iccid = (char **)malloc(num_iccid * sizeof(char *));
-        if (iccid == NULL)
-        {
-            printf("Memory allocation failed\n");
-            cJSON_Delete(json);
-            return -1;
-        }
-        cJSON_ArrayForEach(item, value)
+/**function to load lpa_config on first use
+ *Only the tests that need iccids call it, so a run selecting other tests neither parses nor needs the file.
+ *The outcome is cached, a failed load is reported once and not retried until freeiccid()
+ *OUT : 0 when iccid and the validator are ready, -1 otherwise
+ **/
+int require_iccid(void)
+{
+    if (config_state == 0)
+    {
+        config_state = (get_iccid() == 0) ? 1 : -1;
+        if (config_state < 0)
         {
-            if (i < num_iccid && cJSON_IsString(item))
-            {
-                // Allocate memory for each string and copy the content
-                iccid[i] = (char *)malloc((strlen(item->valuestring) + 1) * sizeof(char));
-                if (iccid[i] == NULL)
-                {
-                    printf("Memory allocation failed\n");
-                    freeiccid();
-                    cJSON_Delete(json);
-                    return -1;
-                }
-
-                strcpy(iccid[i], item->valuestring);
-                i++;
-            }
+            UT_LOG("Failed to get iccid value\n");
         }
     }
-    // Free cJSON object as it is no longer needed
-    cJSON_Delete(json);
-    return 0;
+    return (config_state > 0) ? 0 : -1;
 }
 
 /**
@@ -417,6 +611,104 @@ void test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp(v
     UT_LOG("Exiting test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp...");
 }
 
+/**
+* @brief Test the cellular_esim_download_profile_with_activationcode API with a valid activation code
+*
+* The download is started with an activation code and the progress callback is expected to report the download up to 100 percent, never going backwards. @n
+* @n
+* **Test Group ID:** Basic: 01 @n
+* **Test Case ID:** 031 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** Network access to the SM-DP+ referenced by the activation code @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API with a valid activation code and a progress callback | ActivationCodeStr = "1$smdp-plus.test.gsma.com$", download_progress = lpa_progress_callback | RETURN_OK | Should be successful |
+* | 02 | Wait for the callback to report 100 percent | timeout = DOWNLOAD_PROGRESS_TIMEOUT_MS | progress reaches 100 and never decreases | Should be successful |
+*/
+void test_l1_lpa_hal_positive1_cellular_esim_download_profile_with_activationcode(void)
+{
+    lpa_progress_trace_t trace;
+    char *activation_code = "1$smdp-plus.test.gsma.com$";
+    int result = 0;
+
+    UT_LOG("Entering test_l1_lpa_hal_positive1_cellular_esim_download_profile_with_activationcode...");
+    UT_LOG("Invoking cellular_esim_download_profile_with_activationcode with valid activation code : %s", activation_code);
+    lpa_progress_begin(&trace, 0);
+    result = cellular_esim_download_profile_with_activationcode(activation_code, lpa_progress_callback);
+    trace.return_ns = lpa_perf_now_ns();
+    UT_LOG("cellular_esim_download_profile_with_activationcode Return result: %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    if (result == RETURN_OK)
+    {
+        UT_ASSERT_EQUAL(lpa_progress_end(&trace, 100, DOWNLOAD_PROGRESS_TIMEOUT_MS), 0);
+    }
+    else
+    {
+        lpa_progress_end(&trace, 100, 0);
+    }
+    UT_LOG("%d progress callbacks received, last progress %d", trace.count, trace.last);
+    UT_ASSERT_EQUAL(trace.monotonic, 1);
+    UT_LOG("Exiting test_l1_lpa_hal_positive1_cellular_esim_download_profile_with_activationcode...");
+}
+
+/**
+* @brief Test the cellular_esim_download_profile_with_activationcode API with a NULL activation code
+*
+* **Test Group ID:** Basic: 01 @n
+* **Test Case ID:** 032 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API with a NULL activation code | ActivationCodeStr = NULL, download_progress = lpa_progress_callback | RETURN_ERROR | Should be Fail |
+*/
+void test_l1_lpa_hal_negative1_cellular_esim_download_profile_with_activationcode(void)
+{
+    UT_LOG("Entering test_l1_lpa_hal_negative1_cellular_esim_download_profile_with_activationcode...");
+    UT_LOG("Invoking cellular_esim_download_profile_with_activationcode with NULL activation code");
+    int result = cellular_esim_download_profile_with_activationcode(NULL, lpa_progress_callback);
+    UT_LOG("cellular_esim_download_profile_with_activationcode Return result: %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_ERROR);
+    UT_LOG("Exiting test_l1_lpa_hal_negative1_cellular_esim_download_profile_with_activationcode...");
+}
+
+/**
+* @brief Test the cellular_esim_download_profile_with_activationcode API with a malformed activation code
+*
+* **Test Group ID:** Basic: 01 @n
+* **Test Case ID:** 033 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API with an address that is not an activation code | ActivationCodeStr = "smdp-plus.test.gsma.com", download_progress = lpa_progress_callback | RETURN_ERROR | Should be Fail |
+*/
+void test_l1_lpa_hal_negative2_cellular_esim_download_profile_with_activationcode(void)
+{
+    UT_LOG("Entering test_l1_lpa_hal_negative2_cellular_esim_download_profile_with_activationcode...");
+    char *activation_code = "smdp-plus.test.gsma.com";
+    UT_LOG("Invoking cellular_esim_download_profile_with_activationcode with malformed activation code : %s", activation_code);
+    int result = cellular_esim_download_profile_with_activationcode(activation_code, lpa_progress_callback);
+    UT_LOG("cellular_esim_download_profile_with_activationcode Return result: %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_ERROR);
+    UT_LOG("Exiting test_l1_lpa_hal_negative2_cellular_esim_download_profile_with_activationcode...");
+}
+
 /**
  * @brief Unit testing with CUnit framework for cellular_esim_get_profile_info API.
  *
@@ -438,6 +730,11 @@ void test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp(v
 void test_l1_lpa_hal_positive1_cellular_esim_get_profile_info(void)
 {
     UT_LOG("Entering test_l1_lpa_hal_positive1_cellular_esim_get_profile_info ...");
+    if (require_iccid() != 0)
+    {
+        UT_FAIL("lpa_config is needed to validate the profile list");
+        return;
+    }
 
     int nb_profiles = 0;
     eSIMProfileStruct *profile_list = NULL;
@@ -450,65 +747,56 @@ void test_l1_lpa_hal_positive1_cellular_esim_get_profile_info(void)
     UT_ASSERT_PTR_NOT_NULL(profile_list);
     if(result == RETURN_OK && nb_profiles > 0)
     {
-        UT_LOG("cellular_esim_get_profile_info for nb_profiles :%d",nb_profiles);
+        LPA_LOG_INFO("cellular_esim_get_profile_info for nb_profiles :%d",nb_profiles);
         for(int i = 0;i<nb_profiles;i++)
         {
-            UT_LOG("profile : %d iccid :%s",i+1,(profile_list+i)->iccid);
-            UT_LOG("profile : %d profileName :%s",i+1,(profile_list+i)->profileName);
-            UT_LOG("profile : %d profileState :%d",i+1,(profile_list+i)->profileState);
-            bool iccid_flag = false;
-            for(int j = 0; j<num_iccid ;j++)
-            {
-                if(!strcmp((profile_list+i)->iccid,iccid[j]))
-                {
-                    iccid_flag = true;
-                    break;
-                }
-
-            }
-            if(iccid_flag)
+            LPA_LOG_INFO("profile : %d iccid :%s",i+1,(profile_list+i)->iccid);
+            LPA_LOG_INFO("profile : %d profileName :%s",i+1,(profile_list+i)->profileName);
+            LPA_LOG_INFO("profile : %d profileState :%d",i+1,(profile_list+i)->profileState);
+            if(lpa_validate_iccid((profile_list+i)->iccid))
             {
-                UT_LOG("profile : %d iccid is valid : %s",i+1,(profile_list+i)->iccid);
+                LPA_LOG_INFO("profile : %d iccid is valid : %s",i+1,(profile_list+i)->iccid);
                 UT_PASS("valid iccid");
             }
             else
             {
-                UT_LOG("profile : %d iccid is invalid : %s",i+1,(profile_list+i)->iccid);
+                LPA_LOG_WARN("profile : %d iccid is invalid : %s",i+1,(profile_list+i)->iccid);
                 UT_FAIL("invalid iccid");
             }
             
-            if(!strcmp((profile_list+i)->profileName, "Xfinity Mobile") || !strcmp((profile_list+i)->profileName ,"Comcast") || !strcmp((profile_list+i)->profileName, "CRTC"))
+            if(lpa_validate_profile_name((profile_list+i)->profileName))
             {
-                UT_LOG("profile : %d cellular_esim_get_profile_info profileName value is %s which is a valid value",i+1,(profile_list+i)->profileName);
+                LPA_LOG_INFO("profile : %d cellular_esim_get_profile_info profileName value is %s which is a valid value",i+1,(profile_list+i)->profileName);
                 UT_PASS("cellular_esim_get_profile_info profile_list of profileName value validation success");
             }
             else
             {
-                UT_LOG("profile : %d cellular_esim_get_profile_info profileName value is %s which is a invalid value",i+1,(profile_list+i)->profileName);
+                LPA_LOG_WARN("profile : %d cellular_esim_get_profile_info profileName value is %s which is a invalid value",i+1,(profile_list+i)->profileName);
                 UT_FAIL("cellular_esim_get_profile_info profile_list of profileName value  validation failed");
             }
             if(((profile_list+i)->profileState == 00) || ((profile_list+i)->profileState == 01))
             {
-                UT_LOG("profile : %d cellular_esim_get_profile_info profileState value is %s which is a valid value",i+1,(profile_list+i)->profileState);
+                LPA_LOG_INFO("profile : %d cellular_esim_get_profile_info profileState value is %d which is a valid value",i+1,(profile_list+i)->profileState);
                 UT_PASS("cellular_esim_get_profile_info profile_list of profileName value validation success");
             }
             else
             {
-                UT_LOG("profile : %d cellular_esim_get_profile_info profileState value is %s which is a invalid value",i+1,(profile_list+i)->profileState);
+                LPA_LOG_WARN("profile : %d cellular_esim_get_profile_info profileState value is %d which is a invalid value",i+1,(profile_list+i)->profileState);
                 UT_FAIL("cellular_esim_get_profile_info profile_list of profileState value  validation failed");
             }
             if((nb_profiles >= 0) && (nb_profiles <= 2147483647))
             {
-                UT_LOG("profile : %d cellular_esim_get_profile_info nb_profiles value is %d which is a valid value",i+1,nb_profiles);
+                LPA_LOG_INFO("profile : %d cellular_esim_get_profile_info nb_profiles value is %d which is a valid value",i+1,nb_profiles);
                 UT_PASS("cellular_esim_get_profile_info nb_profiles of profileName value validation success");
             }
             else
             {
-                UT_LOG("profile : %d cellular_esim_get_profile_info nb_profiles value is %d which is a invalid value",i+1,nb_profiles);
+                LPA_LOG_WARN("profile : %d cellular_esim_get_profile_info nb_profiles value is %d which is a invalid value",i+1,nb_profiles);
                 UT_FAIL("cellular_esim_get_profile_info nb_profiles of profileState value  validation failed");
             }
         }
     }
+    lpa_log_flush();
     if(nb_profiles == 0)
     {
         UT_LOG("No profiles available");
@@ -539,9 +827,8 @@ void test_l1_lpa_hal_negative1_cellular_esim_get_profile_info(void)
 {
     UT_LOG("Entering test_l1_lpa_hal_negative1_cellular_esim_get_profile_info ...");
     int nb_profiles = 0;
-    eSIMProfileStruct **profile_list =NULL; 
     UT_LOG("Invoking cellular_esim_get_profile_info with NULL profile list parameters.");
-    int result = cellular_esim_get_profile_info(&profile_list, &nb_profiles);
+    int result = cellular_esim_get_profile_info(NULL, &nb_profiles);
     UT_LOG("cellular_esim_get_profile_info Return result: %d", result);
     UT_ASSERT_EQUAL(result, RETURN_ERROR);
     UT_LOG("Exiting test_l1_lpa_hal_negative1_cellular_esim_get_profile_info ...");
@@ -606,139 +893,22 @@ void test_l1_lpa_hal_positive1_cellular_esim_enable_profile( void )
     UT_LOG("Entering test_l1_lpa_hal_positive1_cellular_esim_enable_profile...");
     int iccid_size =20;
     int ret_value = 0;
+    if (require_iccid() != 0)
+    {
+        UT_FAIL("lpa_config is needed for the valid iccids");
+        return;
+    }
     for (int i = 0;i < num_iccid; i++)
     {
-        UT_LOG("Invoking cellular_esim_enable_profile with valid iccid : %s and iccid_size : %d.",iccid[i],iccid_size);
+        LPA_LOG_INFO("Invoking cellular_esim_enable_profile with valid iccid : %s and iccid_size : %d.",iccid[i],iccid_size);
         ret_value = cellular_esim_enable_profile(iccid[i], iccid_size);
-        UT_LOG("cellular_esim_enable_profile Return ret_value : %d", ret_value);
+        LPA_LOG_INFO("cellular_esim_enable_profile Return ret_value : %d", ret_value);
         UT_ASSERT_EQUAL(ret_value, RETURN_OK);
     }
+    lpa_log_flush();
     UT_LOG("Exiting test_l1_lpa_hal_positive1_cellular_esim_enable_profile...");
 }
 
-/**
-* @brief Test to check the handling of NULL iccid input case in the cellular_esim_enable_profile API function
-*
-* The function is designed to test the error behavior API when provided with a NULL iccid input. @n
-* @n
-* **Test Group ID:** Basic: 01 @n
-* **Test Case ID:** 013 @n
-* **Priority:** High @n
-*  @n
-* **Pre-Conditions:** None @n
-* **Dependencies:** None @n
-* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console @n
-*  @n
-* **Test Procedure:**@n
-* | Variation / Step | Description | Test Data |Expected Result |Notes |
-* | ---- | --------- | ---------- |-------------- | ----- |
-* | 01 | Invoke the API cellular_esim_enable_profile API with NULL iccid | iccid = NULL, iccid_size = 20 | RETURN_ERR | Should be Fail |
-*/
-
-void test_l1_lpa_hal_negative1_cellular_esim_enable_profile( void )
-{
-    UT_LOG("Entering test_l1_lpa_hal_negative1_cellular_esim_enable_profile...");
-    char *iccid = NULL; 
-    int iccid_size = 20;
-    int ret_value = 0;
-    UT_LOG("Invoking cellular_esim_enable_profile with NULL iccid ");
-    ret_value = cellular_esim_enable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_enable_profile Return ret_value: %d", ret_value);
-    UT_ASSERT_EQUAL(ret_value, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative1_cellular_esim_enable_profile...");
-}
-
-/**
- * @brief Test function for negative scenarios in cellular_esim_enable_profile API.
- *
- * This test is focused on validating the cellular_esim_enable_profile API response when iccid is Invalid. @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 014 @n
- * **Priority:** High @n
- *  @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- *  @n
- * **Test Procedure:**@n
- * | Variation / Step | Description | Test Data |Expected Result |Notes |
- * | :----: | --------- | ---------- |-------------- | ----- |
- * | 01 | Invoke cellular_esim_enable_profile API with a Invalid value for iccid | iccid = "98414102915071@#0054", iccid_size = 20 | RETURN_ERR | Should fail |
- */
-void test_l1_lpa_hal_negative2_cellular_esim_enable_profile( void )
-{
-    UT_LOG("Entering test_l1_lpa_hal_negative2_cellular_esim_enable_profile...");
-    char *iccid = "98414102915071@#0054";
-    int iccid_size = 20;
-    int ret_value = 0;
-    UT_LOG("Invoking cellular_esim_enable_profile with alphanumeric value : %s",iccid);
-    ret_value = cellular_esim_enable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_enable_profile Return ret_value: %d", ret_value);
-    UT_ASSERT_EQUAL(ret_value, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative2_cellular_esim_enable_profile...");
-}
-/**
- * @brief Test function for cellular_esim_enable_profile API.
- *
- * This test is focused on validating the cellular_esim_enable_profile API response when iccid is empty string. @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 015 @n
- * **Priority:** High @n
- *  @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- *  @n
- * **Test Procedure:**@n
- * | Variation / Step | Description | Test Data |Expected Result |Notes |
- * | :----: | --------- | ---------- |-------------- | ----- |
- * | 01 | Invoke cellular_esim_enable_profile API with empty string for iccid | iccid = "", iccid_size = 20 | RETURN_ERR | Should fail |
- */
-void test_l1_lpa_hal_negative3_cellular_esim_enable_profile( void )
-{
-    UT_LOG("Entering test_l1_lpa_hal_negative3_cellular_esim_enable_profile...");
-    char *iccid = "";
-    int iccid_size = 20;
-    int ret_value = 0;
-    UT_LOG("Invoking cellular_esim_enable_profile with Empty string ");
-    ret_value = cellular_esim_enable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_enable_profile Return ret_value: %d", ret_value);
-    UT_ASSERT_EQUAL(ret_value, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative3_cellular_esim_enable_profile...");
-}
-/**
- * @brief Test function for negative scenarios in cellular_esim_enable_profile API.
- *
- * This test is focused on validating the cellular_esim_enable_profile API response when iccid is invalid. @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 016 @n
- * **Priority:** High @n
- *  @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- *  @n
- * **Test Procedure:**@n
- * | Variation / Step | Description | Test Data |Expected Result |Notes |
- * | :----: | --------- | ---------- |-------------- | ----- |
- * | 01 | Invoke cellular_esim_enable_profile API with Invalid value | iccid = "random", iccid_size = 20 | RETURN_ERR | Should fail |
- */
-void test_l1_lpa_hal_negative4_cellular_esim_enable_profile( void )
-{
-    UT_LOG("Entering test_l1_lpa_hal_negative4_cellular_esim_enable_profile...");
-    char *iccid = "random";
-    int iccid_size = 20;
-    int ret_value = 0;
-    UT_LOG("Invoking cellular_esim_enable_profile with Invalid iccid : %s",iccid);
-    ret_value = cellular_esim_enable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_enable_profile Return ret_value: %d", ret_value);
-    UT_ASSERT_EQUAL(ret_value, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative4_cellular_esim_enable_profile...");
-}
-
 /**
  * @brief Tests the positive scenario of the cellular_esim_disable_profile API
  *
@@ -761,286 +931,161 @@ void test_l1_lpa_hal_positive1_cellular_esim_disable_profile(void)
 {
     UT_LOG("Entering test_l1_lpa_hal_positive1_cellular_esim_disable_profile...");
     int iccid_size = 20;
+    if (require_iccid() != 0)
+    {
+        UT_FAIL("lpa_config is needed for the valid iccids");
+        return;
+    }
     for (int i = 0;i < num_iccid; i++)
     {
-        UT_LOG("Invoking cellular_esim_disable_profile() with  valid iccid: %s and iccid_size: %d",iccid[i],iccid_size); 
+        LPA_LOG_INFO("Invoking cellular_esim_disable_profile() with  valid iccid: %s and iccid_size: %d",iccid[i],iccid_size); 
         int result = cellular_esim_disable_profile(iccid[i], iccid_size);
-        UT_LOG("cellular_esim_disable_profile Return result: %d", result);
+        LPA_LOG_INFO("cellular_esim_disable_profile Return result: %d", result);
         UT_ASSERT_EQUAL(result, RETURN_OK);
     }
+    lpa_log_flush();
     UT_LOG("Exiting test_l1_lpa_hal_positive1_cellular_esim_disable_profile...");
 }
 
 /**
-* @brief This test functions checks the negative behaviour of the function cellular_esim_disable_profile
+* @brief Tests eSIM profile deletion on a cellular device
 *
-* This test stimulates the scenario where the function cellular_esim_disable_profile is invoked with NULL iccid and an integer size of 20.  @n
+* This test case validates the eSIM profile deletion on a cellular device. @n
 * @n
 * **Test Group ID:** Basic: 01 @n
-* **Test Case ID:** 018 @n
+* **Test Case ID:** 022 @n
 * **Priority:** High @n
-*  @n
+* @n
 * **Pre-Conditions:** None @n
 * **Dependencies:** None @n
-* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
 *  @n
 * **Test Procedure:**@n
 * | Variation / Step | Description | Test Data |Expected Result |Notes |
 * | :----: | --------- | ---------- |-------------- | ----- |
-* | 01 | Invoke cellular_esim_disable_profile() with NULL iccid and iccid_size equals to 20 | iccid = NULL, iccid_size = 20 | RETURN_ERR | Should be Fail |
+* | 01 | Invoking API cellular_esim_delete_profile with valid iccid value and iccid_size | iccid = valid, iccid_size = 20 | RETURN_OK | should be successful |
 */
-
-void test_l1_lpa_hal_negative1_cellular_esim_disable_profile(void) 
+void test_l1_lpa_hal_positive1_cellular_esim_delete_profile(void) 
 {
-    UT_LOG("Entering test_l1_lpa_hal_negative1_cellular_esim_disable_profile...");
-    char *iccid = NULL;
+    UT_LOG("Entering test_l1_lpa_hal_positive1_cellular_esim_delete_profile...");
     int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_disable_profile() with NULL iccid ");
-    int result = cellular_esim_disable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_disable_profile Return result: %d", result);
-    UT_ASSERT_EQUAL(result, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative1_cellular_esim_disable_profile...");
+    if (require_iccid() != 0)
+    {
+        UT_FAIL("lpa_config is needed for the valid iccids");
+        return;
+    }
+    for (int i = 0;i < num_iccid; i++)
+    {
+        LPA_LOG_INFO("Invoking cellular_esim_delete_profile with a valid ICCID : %s and iccid_size : %d",iccid[i],iccid_size);
+        int status = cellular_esim_delete_profile(iccid[i], iccid_size);
+        LPA_LOG_INFO("cellular_esim_delete_profile Return status: %d", status);
+        UT_ASSERT_EQUAL(status, RETURN_OK);
+    }
+    lpa_log_flush();
+    UT_LOG("Exiting test_l1_lpa_hal_positive1_cellular_esim_delete_profile...");
 }
 
 /**
-* @brief This test case investigates the function cellular_esim_disable_profile() with an iccid containing alphanumeric or special characters.
+* @brief Negative iccid matrix of cellular_esim_enable_profile, cellular_esim_disable_profile and cellular_esim_delete_profile
 *
-* In this test, the function cellular_esim_disable_profile() is invoked with a iccid that includes alphanumeric or special characters and a iccid_size equals to 20. @n
+* Each line of L1_ICCID_NEGATIVE_CASES is one test case: the API, the variation, the test case ID,
+* the iccid and iccid_size handed to the API and a description of the input. The line generates
+* test_l1_lpa_hal_negative<variation>_cellular_esim_<api>() and its registration, all cases share
+* the body of l1_iccid_negative(). @n
 * @n
 * **Test Group ID:** Basic: 01 @n
-* **Test Case ID:** 019 @n
+* **Test Case ID:** 013 - 016, 018 - 021, 023 - 026 @n
 * **Priority:** High @n
-* @n
+*  @n
 * **Pre-Conditions:** None @n
 * **Dependencies:** None @n
-* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console @n
 *  @n
 * **Test Procedure:**@n
 * | Variation / Step | Description | Test Data |Expected Result |Notes |
 * | :----: | --------- | ---------- |-------------- | ----- |
-* | 01 | Invoking cellular_esim_disable_profile() with ICCID containing alphanumeric and special characters | iccid = "98410A00@04860024951", iccid_size = 20 | RETURN_ERR | Should be Fail |
+* | 01 | Invoke the API with the iccid of the case | iccid, iccid_size = 20 | RETURN_ERR | Should be Fail |
 */
-void test_l1_lpa_hal_negative2_cellular_esim_disable_profile(void) 
-{
-    UT_LOG("Entering test_l1_lpa_hal_negative2_cellular_esim_disable_profile...");
-    char *iccid = "98410A00@04860024951";
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_disable_profile() with iccid contains alphanumeric or special characters : %s",iccid);
-    int result = cellular_esim_disable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_disable_profile Return result: %d", result);
-    UT_ASSERT_EQUAL(result, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative2_cellular_esim_disable_profile..."); 
-}
+#define L1_ICCID_NEGATIVE_CASES(X) \
+    X(enable_profile,  1, "013", NULL,                   20, "NULL iccid") \
+    X(enable_profile,  2, "014", "98414102915071@#0054", 20, "alphanumeric iccid") \
+    X(enable_profile,  3, "015", "",                     20, "empty iccid") \
+    X(enable_profile,  4, "016", "random",               20, "invalid iccid") \
+    X(disable_profile, 1, "018", NULL,                   20, "NULL iccid") \
+    X(disable_profile, 2, "019", "98410A00@04860024951", 20, "alphanumeric iccid") \
+    X(disable_profile, 3, "020", "984141",               20, "short iccid") \
+    X(disable_profile, 4, "021", "",                     20, "empty iccid") \
+    X(delete_profile,  1, "023", NULL,                   20, "NULL iccid") \
+    X(delete_profile,  2, "024", "98109909002@43658739", 20, "alphanumeric iccid") \
+    X(delete_profile,  3, "025", "",                     20, "empty iccid") \
+    X(delete_profile,  4, "026", "random",               20, "invalid iccid")
 
-/**
- * @brief This unit test is to check the behavior of the API 'cellular_esim_disable_profile' when invokded with empty ICCID
- *
- * In this test, the API cellular_esim_disable_profile is invoked with invalid ICCID and ICCID size equal to 20. @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 020 @n
- * **Priority:** High @n
- * @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- * @n
- * **Test Procedure:** @n
- * | Variation / Step | Description | Test Data |Expected Result |Notes |
- * | :----: | --------- | ---------- |-------------- | ----- |
- * | 01 | Invoke cellular_esim_disable_profile() with Invalid iccid string and iccid_size equals to 20  | iccid = invalid value, iccid_size = 20 | RETURN_ERR |  should be fail |
- */
-void test_l1_lpa_hal_negative3_cellular_esim_disable_profile(void) 
-{
-    UT_LOG("Entering test_l1_lpa_hal_negative3_cellular_esim_disable_profile...");
-    char *iccid = "984141";
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_disable_profile() with Invalid iccid string: %s",iccid);
-    int result = cellular_esim_disable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_disable_profile Return result: %d", result);
-    UT_ASSERT_EQUAL(result, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative3_cellular_esim_disable_profile...");
-}
+typedef int (*l1_iccid_api_t)(char *iccid, int iccid_size);
 
-/**
-* @brief Test for the cellular_esim_disable_profile API .
-*
-* This test validates the cellular_esim_disable_profile() function by testing if it can handle Empty string iccid and valid iccid_size . @n
-* @n
-* **Test Group ID:** Basic: 01 @n
-* **Test Case ID:** 021 @n
-* **Priority:** High @n
-* @n
-* **Pre-Conditions:** None @n
-* **Dependencies:** None @n
-* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
-* @n
-* **Test Procedure:**@n
-* | Variation / Step | Description | Test Data |Expected Result |Notes |
-* | :----: | --------- | ---------- |-------------- | ----- |
-* | 01 | Invoke cellular_esim_disable_profile() with Empty iccid and iccid_size equals to 20. | iccid = "", iccid_size = 20 | RETURN_ERR | Should be Fail |
-*/
+typedef struct
+{
+    const char *function;       /* registered without its "test_" prefix */
+    UT_TestFunction_t test;
+    const char *case_id;
+    const char *api_name;
+    l1_iccid_api_t api;
+    const char *iccid;
+    int iccid_size;
+    const char *input;
+} l1_iccid_case_t;
 
-void test_l1_lpa_hal_negative4_cellular_esim_disable_profile(void) 
+/* Direct calls rather than pointers to the APIs, so LPA_TRACE still sees them */
+static int l1_call_enable_profile(char *iccid, int iccid_size)
 {
-    UT_LOG("Entering test_l1_lpa_hal_negative4_cellular_esim_disable_profile...");
-    char *iccid = "";
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_disable_profile() with Empty iccid ");
-    int result = cellular_esim_disable_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_disable_profile Return result: %d", result);
-    UT_ASSERT_EQUAL(result, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative4_cellular_esim_disable_profile...");
+    return cellular_esim_enable_profile(iccid, iccid_size);
 }
 
-/**
-* @brief Tests eSIM profile deletion on a cellular device
-*
-* This test case validates the eSIM profile deletion on a cellular device. @n
-* @n
-* **Test Group ID:** Basic: 01 @n
-* **Test Case ID:** 022 @n
-* **Priority:** High @n
-* @n
-* **Pre-Conditions:** None @n
-* **Dependencies:** None @n
-* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
-*  @n
-* **Test Procedure:**@n
-* | Variation / Step | Description | Test Data |Expected Result |Notes |
-* | :----: | --------- | ---------- |-------------- | ----- |
-* | 01 | Invoking API cellular_esim_delete_profile with valid iccid value and iccid_size | iccid = valid, iccid_size = 20 | RETURN_OK | should be successful |
-*/
-void test_l1_lpa_hal_positive1_cellular_esim_delete_profile(void) 
+static int l1_call_disable_profile(char *iccid, int iccid_size)
 {
-    UT_LOG("Entering test_l1_lpa_hal_positive1_cellular_esim_delete_profile...");
-    int iccid_size = 20;
-    for (int i = 0;i < num_iccid; i++)
-    {
-        UT_LOG("Invoking cellular_esim_delete_profile with a valid ICCID : %s and iccid_size : %d",iccid[i],iccid_size);
-        int status = cellular_esim_delete_profile(iccid[i], iccid_size);
-        UT_LOG("cellular_esim_delete_profile Return status: %d", status);
-        UT_ASSERT_EQUAL(status, RETURN_OK);
-    }
-    UT_LOG("Exiting test_l1_lpa_hal_positive1_cellular_esim_delete_profile...");
+    return cellular_esim_disable_profile(iccid, iccid_size);
 }
 
-/**
- * @brief Tests negative scenarios for cellular_esim_delete_profile function
- *
- * This test checks whether the cellular_esim_delete_profile function is able to handle NULL ICCID argument, which is an invalid input. @n 
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 023 @n
- * **Priority:** High @n
- * @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console
- * @n
- * **Test Procedure:**@n
- * | Variation / Step | Description   | Test Data     | Expected Result   | Notes |
- * | :-------------:  | ---------     | ----------    | --------------    | ----- |
- * | 01 |Invoke cellular_esim_delete_profile API with NULL iccid value | iccid = NULL, iccid_size = 20 | RETURN_ERR | Should fail |
- */
-void test_l1_lpa_hal_negative1_cellular_esim_delete_profile(void)
+static int l1_call_delete_profile(char *iccid, int iccid_size)
 {
-    UT_LOG("Entering test_l1_lpa_hal_negative1_cellular_esim_delete_profile...");
-    char *iccid = NULL;
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_delete_profile with NULL ICCID. ");
-    int status = cellular_esim_delete_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_delete_profile Return status: %d", status);
-    UT_ASSERT_EQUAL(status, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative1_cellular_esim_delete_profile...");
+    return cellular_esim_delete_profile(iccid, iccid_size);
 }
 
-/**
- * @brief Tests negative scenarios for cellular_esim_delete_profile function
- *
- * This test checks whether the cellular_esim_delete_profile function is able to handle invalid ICCID argument input.  @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 024 @n
- * **Priority:** High @n
- *  @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- *  @n
- * **Test Procedure:**@n
- * | Variation / Step | Description   | Test Data      | Expected Result      | Notes |
- * | :-------------:  | ---------     | ----------     | --------------       | ----- |
- * | 01 |Invoke cellular_esim_delete_profile API with invalid alphanumeric iccid value | iccid = 98109909002@43658739, iccid_size = 20 | RETURN_ERR | Should fail |
- */
-void test_l1_lpa_hal_negative2_cellular_esim_delete_profile(void)
+#define L1_ICCID_CASE_INDEX(api, n, id, value, size, input) L1_ICCID_##api##_##n,
+enum
 {
-    UT_LOG("Entering test_l1_lpa_hal_negative2_cellular_esim_delete_profile...");
-    char *iccid = "98109909002@43658739";
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_delete_profile with Invalid ICCID : %s",iccid);
-    int status = cellular_esim_delete_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_delete_profile Return status: %d", status);
-    UT_ASSERT_EQUAL(status, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative2_cellular_esim_delete_profile...");
-}
-/**
- * @brief Tests negative scenarios for cellular_esim_delete_profile function
- *
- * This test checks whether the cellular_esim_delete_profile function is able to handle ICCID argument, which is an invalid input.  @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 025 @n
- * **Priority:** High @n
- *  @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- *  @n
- * **Test Procedure:**@n
- * | Variation / Step | Description   | Test Data    | Expected Result     | Notes |
- * | :-------------:  | ---------     | ----------   | --------------      | ----- |
- * |     01           |Invoke cellular_esim_delete_profile API with Empty string ICCID value | iccid = "", iccid_size = 20  | RETURN_ERR | Should be Fail |
- */
-void test_l1_lpa_hal_negative3_cellular_esim_delete_profile(void)
+    L1_ICCID_NEGATIVE_CASES(L1_ICCID_CASE_INDEX)
+    L1_ICCID_CASE_MAX
+};
+
+static void l1_iccid_negative(int index);
+
+#define L1_ICCID_CASE_FUNCTION(api, n, id, value, size, input) \
+    void test_l1_lpa_hal_negative##n##_cellular_esim_##api(void) \
+    { \
+        l1_iccid_negative(L1_ICCID_##api##_##n); \
+    }
+L1_ICCID_NEGATIVE_CASES(L1_ICCID_CASE_FUNCTION)
+
+#define L1_ICCID_CASE_ENTRY(api, n, id, value, size, input) \
+    { "test_l1_lpa_hal_negative" #n "_cellular_esim_" #api, test_l1_lpa_hal_negative##n##_cellular_esim_##api, \
+      id, "cellular_esim_" #api, l1_call_##api, value, size, input },
+static const l1_iccid_case_t l1_iccid_case[L1_ICCID_CASE_MAX] =
 {
-    UT_LOG("Entering test_l1_lpa_hal_negative3_cellular_esim_delete_profile...");
-    char *iccid = "";
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_delete_profile with Empty string of ICCID ");
-    int status = cellular_esim_delete_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_delete_profile Return status: %d", status);
-    UT_ASSERT_EQUAL(status, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative3_cellular_esim_delete_profile...");
-}
-/**
- * @brief Tests negative scenarios for cellular_esim_delete_profile function.
- *
- * This test checks whether the cellular_esim_delete_profile function is able to handle ICCID argument, which is an invalid input.  @n
- * @n
- * **Test Group ID:** Basic: 01 @n
- * **Test Case ID:** 026 @n
- * **Priority:** High @n
- *  @n
- * **Pre-Conditions:** None @n
- * **Dependencies:** None @n
- * **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
- *  @n
- * **Test Procedure:**@n
- * | Variation / Step | Description   | Test Data        | Expected Result     | Notes |
- * | :-------------:  | ---------     | ----------       | --------------      | ----- |
- * |     01   |Invoke cellular_esim_delete_profile API with Invalid ICCID value | iccid = random, iccid_size = 20  | RETURN_ERR | Should be Fail |
- */
-void test_l1_lpa_hal_negative4_cellular_esim_delete_profile(void)
+    L1_ICCID_NEGATIVE_CASES(L1_ICCID_CASE_ENTRY)
+};
+
+static void l1_iccid_negative(int index)
 {
-    UT_LOG("Entering test_l1_lpa_hal_negative4_cellular_esim_delete_profile...");
-    char *iccid = "random";
-    int iccid_size = 20;
-    UT_LOG("Invoking cellular_esim_delete_profile with Invalid ICCID : %s",iccid);
-    int status = cellular_esim_delete_profile(iccid, iccid_size);
-    UT_LOG("cellular_esim_delete_profile Return status: %d", status);
-    UT_ASSERT_EQUAL(status, RETURN_ERROR);
-    UT_LOG("Exiting test_l1_lpa_hal_negative4_cellular_esim_delete_profile...");
+    const l1_iccid_case_t *test = &l1_iccid_case[index];
+    int result = 0;
+
+    UT_LOG("Entering %s (test case %s)...", test->function, test->case_id);
+    UT_LOG("Invoking %s with %s : %s, iccid_size : %d", test->api_name, test->input,
+           (test->iccid != NULL) ? test->iccid : "NULL", test->iccid_size);
+    result = test->api((char *)test->iccid, test->iccid_size);
+    UT_LOG("%s Return result: %d", test->api_name, result);
+    UT_ASSERT_EQUAL(result, RETURN_ERROR);
+    UT_LOG("Exiting %s...", test->function);
 }
 
 /**
@@ -1180,7 +1225,7 @@ void test_l1_lpa_hal_positive1_cellular_esim_get_euicc(void)
 
 int init_cellular_esim_init(){
     int ret = 0;
-    ret = cellular_esim_lpa_init();
+    ret = lpa_perf_hal_init();
     if (ret == 0)
     {
         UT_LOG("celular_esim init returned success");
@@ -1207,6 +1252,58 @@ int clean_cellular_esim_exit(){
     return 0;
 }
 static UT_test_suite_t * pSuite = NULL;
+static int l1_group = -1;
+
+/* Register the test when it belongs to the group selected, or when no group is */
+static void l1_add_test(lpa_shard_group_t group, const char *name, UT_TestFunction_t function)
+{
+    if ((l1_group < 0) || (l1_group == (int)group))
+    {
+        UT_add_test( pSuite, name, function);
+    }
+}
+
+/* Registers the negative iccid cases of one API, in table order */
+static void l1_add_iccid_negative_tests(l1_iccid_api_t api)
+{
+    int i = 0;
+
+    for (i = 0; i < L1_ICCID_CASE_MAX; i++)
+    {
+        if (l1_iccid_case[i].api == api)
+        {
+            l1_add_test(LPA_SHARD_PROFILE_STATE, l1_iccid_case[i].function + strlen("test_"), l1_iccid_case[i].test);
+        }
+    }
+}
+
+static void l1_add_tests(void)
+{
+    l1_add_test( LPA_SHARD_DOWNLOAD_SMDS, "l1_lpa_hal_positive1_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_positive1_cellular_esim_download_profile_from_smds);
+    l1_add_test( LPA_SHARD_DOWNLOAD_SMDS, "l1_lpa_hal_negative1_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_negative1_cellular_esim_download_profile_from_smds);
+    l1_add_test( LPA_SHARD_DOWNLOAD_SMDS, "l1_lpa_hal_negative2_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_negative2_cellular_esim_download_profile_from_smds);
+    l1_add_test( LPA_SHARD_DOWNLOAD_SMDS, "l1_lpa_hal_negative3_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_smds);
+    l1_add_test( LPA_SHARD_DOWNLOAD_DEFAULTSMDP, "l1_lpa_hal_positive1_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_positive1_cellular_esim_download_profile_from_defaultsmdp);
+    l1_add_test( LPA_SHARD_DOWNLOAD_DEFAULTSMDP, "l1_lpa_hal_negative1_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_negative1_cellular_esim_download_profile_from_defaultsmdp);
+    l1_add_test( LPA_SHARD_DOWNLOAD_DEFAULTSMDP, "l1_lpa_hal_negative2_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_negative2_cellular_esim_download_profile_from_defaultsmdp);
+    l1_add_test( LPA_SHARD_DOWNLOAD_DEFAULTSMDP, "l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp);
+    l1_add_test( LPA_SHARD_DOWNLOAD_ACTIVATIONCODE, "l1_lpa_hal_positive1_cellular_esim_download_profile_with_activationcode", test_l1_lpa_hal_positive1_cellular_esim_download_profile_with_activationcode);
+    l1_add_test( LPA_SHARD_DOWNLOAD_ACTIVATIONCODE, "l1_lpa_hal_negative1_cellular_esim_download_profile_with_activationcode", test_l1_lpa_hal_negative1_cellular_esim_download_profile_with_activationcode);
+    l1_add_test( LPA_SHARD_DOWNLOAD_ACTIVATIONCODE, "l1_lpa_hal_negative2_cellular_esim_download_profile_with_activationcode", test_l1_lpa_hal_negative2_cellular_esim_download_profile_with_activationcode);
+    l1_add_test( LPA_SHARD_READ, "l1_lpa_hal_positive1_cellular_esim_get_profile_info", test_l1_lpa_hal_positive1_cellular_esim_get_profile_info);
+    l1_add_test( LPA_SHARD_READ, "l1_lpa_hal_negative1_cellular_esim_get_profile_info", test_l1_lpa_hal_negative1_cellular_esim_get_profile_info);
+    l1_add_test( LPA_SHARD_READ, "l1_lpa_hal_negative2_cellular_esim_get_profile_info", test_l1_lpa_hal_negative2_cellular_esim_get_profile_info);
+    l1_add_test( LPA_SHARD_PROFILE_STATE, "l1_lpa_hal_positive1_cellular_esim_enable_profile", test_l1_lpa_hal_positive1_cellular_esim_enable_profile);
+    l1_add_iccid_negative_tests(l1_call_enable_profile);
+    l1_add_test( LPA_SHARD_PROFILE_STATE, "l1_lpa_hal_positive1_cellular_esim_disable_profile", test_l1_lpa_hal_positive1_cellular_esim_disable_profile);
+    l1_add_iccid_negative_tests(l1_call_disable_profile);
+    l1_add_test( LPA_SHARD_PROFILE_STATE, "l1_lpa_hal_positive1_cellular_esim_delete_profile", test_l1_lpa_hal_positive1_cellular_esim_delete_profile);
+    l1_add_iccid_negative_tests(l1_call_delete_profile);
+    l1_add_test( LPA_SHARD_LIFECYCLE, "l1_lpa_hal_positive1_cellular_esim_lpa_init", test_l1_lpa_hal_positive1_cellular_esim_lpa_init);
+    l1_add_test( LPA_SHARD_LIFECYCLE, "l1_lpa_hal_positive1_cellular_esim_exit", test_l1_lpa_hal_positive1_cellular_esim_exit);
+    l1_add_test( LPA_SHARD_READ, "l1_lpa_hal_positive1_cellular_esim_get_eid", test_l1_lpa_hal_positive1_cellular_esim_get_eid);
+    l1_add_test( LPA_SHARD_READ, "l1_lpa_hal_positive1_cellular_esim_get_euicc", test_l1_lpa_hal_positive1_cellular_esim_get_euicc);
+}
 
 /**
  * @brief Register the main tests for this module
@@ -1220,35 +1317,35 @@ int test_lpa_hal_l1_register(void)
     if (pSuite == NULL) {
         return -1;
     }
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_positive1_cellular_esim_download_profile_from_smds);
-    UT_add_test( pSuite, "l1_lpa_hal_negative1_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_negative1_cellular_esim_download_profile_from_smds);
-    UT_add_test( pSuite, "l1_lpa_hal_negative2_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_negative2_cellular_esim_download_profile_from_smds);
-    UT_add_test( pSuite, "l1_lpa_hal_negative3_cellular_esim_download_profile_from_smds", test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_smds);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_positive1_cellular_esim_download_profile_from_defaultsmdp);
-    UT_add_test( pSuite, "l1_lpa_hal_negative1_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_negative1_cellular_esim_download_profile_from_defaultsmdp);
-    UT_add_test( pSuite, "l1_lpa_hal_negative2_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_negative2_cellular_esim_download_profile_from_defaultsmdp);
-    UT_add_test( pSuite, "l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp", test_l1_lpa_hal_negative3_cellular_esim_download_profile_from_defaultsmdp);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_get_profile_info", test_l1_lpa_hal_positive1_cellular_esim_get_profile_info);
-    UT_add_test( pSuite, "l1_lpa_hal_negative1_cellular_esim_get_profile_info", test_l1_lpa_hal_negative1_cellular_esim_get_profile_info);
-    UT_add_test( pSuite, "l1_lpa_hal_negative2_cellular_esim_get_profile_info", test_l1_lpa_hal_negative2_cellular_esim_get_profile_info);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_enable_profile", test_l1_lpa_hal_positive1_cellular_esim_enable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative1_cellular_esim_enable_profile", test_l1_lpa_hal_negative1_cellular_esim_enable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative2_cellular_esim_enable_profile", test_l1_lpa_hal_negative2_cellular_esim_enable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative3_cellular_esim_enable_profile", test_l1_lpa_hal_negative3_cellular_esim_enable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative4_cellular_esim_enable_profile", test_l1_lpa_hal_negative4_cellular_esim_enable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_disable_profile", test_l1_lpa_hal_positive1_cellular_esim_disable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative1_cellular_esim_disable_profile", test_l1_lpa_hal_negative1_cellular_esim_disable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative2_cellular_esim_disable_profile", test_l1_lpa_hal_negative2_cellular_esim_disable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative3_cellular_esim_disable_profile", test_l1_lpa_hal_negative3_cellular_esim_disable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative4_cellular_esim_disable_profile", test_l1_lpa_hal_negative4_cellular_esim_disable_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_delete_profile", test_l1_lpa_hal_positive1_cellular_esim_delete_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative1_cellular_esim_delete_profile", test_l1_lpa_hal_negative1_cellular_esim_delete_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative2_cellular_esim_delete_profile", test_l1_lpa_hal_negative2_cellular_esim_delete_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative3_cellular_esim_delete_profile", test_l1_lpa_hal_negative3_cellular_esim_delete_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_negative4_cellular_esim_delete_profile", test_l1_lpa_hal_negative4_cellular_esim_delete_profile);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_lpa_init", test_l1_lpa_hal_positive1_cellular_esim_lpa_init);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_exit", test_l1_lpa_hal_positive1_cellular_esim_exit);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_get_eid", test_l1_lpa_hal_positive1_cellular_esim_get_eid);
-    UT_add_test( pSuite, "l1_lpa_hal_positive1_cellular_esim_get_euicc", test_l1_lpa_hal_positive1_cellular_esim_get_euicc);
+    l1_group = -1;
+    l1_add_tests();
+    return 0;
+}
+
+/* Cleanup of a group suite: the counts of the group go to the shard runner */
+static int clean_cellular_esim_group(void)
+{
+    int ret = clean_cellular_esim_exit();
+
+    lpa_shard_group_done();
+    return ret;
+}
+
+/**
+ * @brief Register one group of the tests as the suite "[L1 lpa_hal <group>]", for a shard worker
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_lpa_hal_l1_register_group(lpa_shard_group_t group)
+{
+    static char title[64];
+
+    snprintf(title, sizeof(title), "[L1 lpa_hal %s]", lpa_shard_group_name[group]);
+    pSuite = UT_add_suite(title,init_cellular_esim_init,clean_cellular_esim_group);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    l1_group = (int)group;
+    l1_add_tests();
     return 0;
 }
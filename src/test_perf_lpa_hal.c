@@ -0,0 +1,2021 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_perf_lpa_hal.c
+* @page lpa_hal_perf Performance Tests
+*
+* ## Module's Role
+* This module includes latency benchmarks for every lpa_hal API.
+* Each API is invoked repeatedly after a warm-up phase and the per-call latency is recorded into a
+* log-bucketed histogram, so tail-latency regressions between vendor library drops become visible.
+*
+* **Pre-Conditions:**  lpa_config populated with valid iccid values for the enable/disable benchmarks@n
+* **Dependencies:** None@n
+*
+* Tuning (environment):
+* - LPA_PERF_ITERATIONS : timed calls per API (default 1000)
+* - LPA_PERF_WARMUP : untimed calls before measuring (default 100)
+* - LPA_PERF_DOWNLOAD_ITERATIONS : timed calls per download API (default 100)
+* - LPA_PERF_ACTIVATION_CODE : activation code used by the activation code download benchmark
+* - LPA_PERF_ICCID_COUNT : iccids validated by the bulk iccid validation benchmark (default 1000000)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "lpa_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "lpa_perf.h"
+#include "lpa_log.h"
+#include "lpa_iccid.h"
+#include "lpa_arena.h"
+#include "lpa_smdp_stub.h"
+#include "lpa_synth.h"
+#include "lpa_validate.h"
+#include "lpa_config.h"
+#include "lpa_config_cache.h"
+
+extern int num_iccid;
+extern char** iccid;
+extern int require_iccid(void);
+extern void freeiccid(void);
+
+#define PERF_ICCID_SIZE 20
+
+typedef enum
+{
+    PERF_DOWNLOAD_ACTIVATIONCODE = 0,
+    PERF_DOWNLOAD_SMDS,
+    PERF_DOWNLOAD_DEFAULTSMDP,
+    PERF_GET_PROFILE_INFO,
+    PERF_ENABLE_PROFILE,
+    PERF_DISABLE_PROFILE,
+    PERF_DELETE_PROFILE_REJECT,
+    PERF_LPA_INIT,
+    PERF_LPA_EXIT,
+    PERF_GET_EID,
+    PERF_GET_EUICC,
+    PERF_API_MAX
+} perf_api_t;
+
+static const char *perf_api_name[PERF_API_MAX] =
+{
+    "cellular_esim_download_profile_with_activationcode",
+    "cellular_esim_download_profile_from_smds",
+    "cellular_esim_download_profile_from_defaultsmdp",
+    "cellular_esim_get_profile_info",
+    "cellular_esim_enable_profile",
+    "cellular_esim_disable_profile",
+    "cellular_esim_delete_profile (invalid iccid)",
+    "cellular_esim_lpa_init",
+    "cellular_esim_lpa_exit",
+    "cellular_esim_get_eid",
+    "cellular_esim_get_euicc",
+};
+
+typedef struct
+{
+    lpa_hist_t hist;
+    int errors;
+} perf_result_t;
+
+static perf_result_t perf_results[PERF_API_MAX];
+
+static int perf_iterations = 0;
+static int perf_warmup = 0;
+static int perf_download_iterations = 0;
+static const char *perf_activation_code = NULL;
+static const char *perf_smds = "oem-smds-json.demo.gemalto.com";
+static const char *perf_smdp = "smdp-plus.test.gsma.com";
+/* Loopback SM-DS / SM-DP+, serves the download benchmarks when LPA_PERF_OFFLINE=1 */
+static lpa_smdp_stub_t perf_stub;
+static int perf_stub_running = 0;
+static char perf_stub_address[32];
+static char perf_stub_activation_code[48];
+/* Per-test scratch memory, rewound at the end of each test that uses it */
+static lpa_arena_t perf_scratch;
+
+/* Returns the first configured iccid that is not empty, NULL if lpa_config has none or cannot be loaded */
+static char *perf_first_iccid(void)
+{
+    int i = 0;
+
+    if (require_iccid() != 0)
+    {
+        return NULL;
+    }
+    for (i = 0; i < num_iccid; i++)
+    {
+        if ((iccid[i] != NULL) && (iccid[i][0] != '\0'))
+        {
+            return iccid[i];
+        }
+    }
+    return NULL;
+}
+
+/* perf_profile_state() results that are not a profileState */
+#define PERF_PROFILE_UNLISTED  -1
+#define PERF_PROFILE_ERROR     -2
+
+/* State of `profile` in the list: its profileState, PERF_PROFILE_UNLISTED or PERF_PROFILE_ERROR when the call failed */
+static int perf_profile_state(const char *profile)
+{
+    eSIMProfileStruct *profile_list = NULL;
+    int nb_profiles = 0;
+    int state = PERF_PROFILE_UNLISTED;
+    int i = 0;
+
+    if (cellular_esim_get_profile_info(&profile_list, &nb_profiles) != RETURN_OK)
+    {
+        return PERF_PROFILE_ERROR;
+    }
+    for (i = 0; (profile_list != NULL) && (i < nb_profiles); i++)
+    {
+        if (strncmp(profile_list[i].iccid, profile, PERF_ICCID_SIZE) == 0)
+        {
+            state = profile_list[i].profileState;
+            break;
+        }
+    }
+    free(profile_list);
+    return state;
+}
+
+/* Enable / disable benchmarks need the profile installed, not only named in lpa_config */
+static int perf_profile_listed(const char *profile, const char *benchmark)
+{
+    int state = perf_profile_state(profile);
+
+    if (state >= 0)
+    {
+        return 1;
+    }
+    if (state == PERF_PROFILE_ERROR)
+    {
+        UT_LOG("cellular_esim_get_profile_info failed, skipping %s benchmark", benchmark);
+        return 0;
+    }
+    UT_LOG("%s is not listed by cellular_esim_get_profile_info, skipping %s benchmark", profile, benchmark);
+    return 0;
+}
+
+static void perf_download_progress(int progress)
+{
+    (void)progress;
+}
+
+/* One invocation of the API under test, returns the HAL return code */
+static int perf_invoke(perf_api_t api, char *profile)
+{
+    eSIMProfileStruct *profile_list = NULL;
+    int nb_profiles = 0;
+    int result = RETURN_ERROR;
+
+    switch (api)
+    {
+        case PERF_DOWNLOAD_ACTIVATIONCODE:
+            result = cellular_esim_download_profile_with_activationcode((char *)perf_activation_code, perf_download_progress);
+            break;
+        case PERF_DOWNLOAD_SMDS:
+            result = cellular_esim_download_profile_from_smds((char *)perf_smds);
+            break;
+        case PERF_DOWNLOAD_DEFAULTSMDP:
+            result = cellular_esim_download_profile_from_defaultsmdp((char *)perf_smdp);
+            break;
+        case PERF_GET_PROFILE_INFO:
+            result = cellular_esim_get_profile_info(&profile_list, &nb_profiles);
+            free(profile_list);
+            break;
+        case PERF_ENABLE_PROFILE:
+            result = cellular_esim_enable_profile(profile, PERF_ICCID_SIZE);
+            break;
+        case PERF_DISABLE_PROFILE:
+            result = cellular_esim_disable_profile(profile, PERF_ICCID_SIZE);
+            break;
+        case PERF_DELETE_PROFILE_REJECT:
+            result = cellular_esim_delete_profile("98414102915071@#0054", PERF_ICCID_SIZE);
+            break;
+        case PERF_LPA_INIT:
+            result = cellular_esim_lpa_init();
+            break;
+        case PERF_LPA_EXIT:
+            result = cellular_esim_lpa_exit();
+            break;
+        case PERF_GET_EID:
+            result = cellular_esim_get_eid();
+            break;
+        case PERF_GET_EUICC:
+            result = cellular_esim_get_euicc();
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+/**
+ * @brief Warm up then time `iterations` calls of `api`
+ *
+ * When `setup` is a valid api it is invoked untimed before every call of `api`, which keeps
+ * state-mutating APIs (enable/disable, init/exit) in a state where the measured call is legal.
+ */
+static void perf_run(perf_api_t api, perf_api_t setup, int iterations, int warmup, char *profile, int expected)
+{
+    perf_result_t *res = &perf_results[api];
+    uint64_t start = 0;
+    int result = 0;
+    int i = 0;
+
+    lpa_hist_reset(&res->hist);
+    res->errors = 0;
+
+    for (i = 0; i < warmup + iterations; i++)
+    {
+        if (setup != PERF_API_MAX)
+        {
+            perf_invoke(setup, profile);
+        }
+        start = lpa_perf_now_ns();
+        result = perf_invoke(api, profile);
+        if (i < warmup)
+        {
+            continue;
+        }
+        lpa_hist_record(&res->hist, lpa_perf_now_ns() - start);
+        if (result != expected)
+        {
+            res->errors++;
+        }
+    }
+}
+
+/* perf_run() then print the latency row, every call is expected to return `expected` */
+static void perf_measure(perf_api_t api, perf_api_t setup, int iterations, int warmup, char *profile, int expected)
+{
+    perf_result_t *res = &perf_results[api];
+
+    perf_run(api, setup, iterations, warmup, profile, expected);
+    lpa_hist_print_row(perf_api_name[api], &res->hist, res->errors);
+    UT_ASSERT_EQUAL(res->errors, 0);
+}
+
+static void perf_download_warmup(int *iterations, int *warmup)
+{
+    *iterations = perf_download_iterations;
+    *warmup = (perf_warmup < perf_download_iterations / 10) ? perf_warmup : perf_download_iterations / 10;
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_download_profile_with_activationcode
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 001 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** Network access to the SM-DP+ referenced by the activation code @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_DOWNLOAD_ITERATIONS times after warm-up and record each latency | ActivationCodeStr = LPA_PERF_ACTIVATION_CODE | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_download_profile_with_activationcode(void)
+{
+    int iterations = 0;
+    int warmup = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_download_profile_with_activationcode...");
+    perf_download_warmup(&iterations, &warmup);
+    perf_measure(PERF_DOWNLOAD_ACTIVATIONCODE, PERF_API_MAX, iterations, warmup, NULL, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_download_profile_with_activationcode...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_download_profile_from_smds
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 002 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** Network access to the SM-DS @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_DOWNLOAD_ITERATIONS times after warm-up and record each latency | smds = "oem-smds-json.demo.gemalto.com" | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_download_profile_from_smds(void)
+{
+    int iterations = 0;
+    int warmup = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_download_profile_from_smds...");
+    perf_download_warmup(&iterations, &warmup);
+    perf_measure(PERF_DOWNLOAD_SMDS, PERF_API_MAX, iterations, warmup, NULL, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_download_profile_from_smds...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_download_profile_from_defaultsmdp
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 003 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** Network access to the default SM-DP+ @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_DOWNLOAD_ITERATIONS times after warm-up and record each latency | smdp = "smdp-plus.test.gsma.com" | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_download_profile_from_defaultsmdp(void)
+{
+    int iterations = 0;
+    int warmup = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_download_profile_from_defaultsmdp...");
+    perf_download_warmup(&iterations, &warmup);
+    perf_measure(PERF_DOWNLOAD_DEFAULTSMDP, PERF_API_MAX, iterations, warmup, NULL, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_download_profile_from_defaultsmdp...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_get_profile_info
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 004 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_ITERATIONS times after warm-up, freeing the returned list after each call | profile_list = valid pointer, nb_profiles = valid buffer | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_get_profile_info(void)
+{
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_get_profile_info...");
+    perf_measure(PERF_GET_PROFILE_INFO, PERF_API_MAX, perf_iterations, perf_warmup, NULL, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_get_profile_info...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_enable_profile
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 005 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** lpa_config holds at least one valid iccid, installed on the eUICC (skipped otherwise) @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Disable the profile (untimed) then time cellular_esim_enable_profile, LPA_PERF_ITERATIONS times | iccid = first configured iccid, iccid_size = 20 | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_enable_profile(void)
+{
+    char *profile = perf_first_iccid();
+
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_enable_profile...");
+    if (profile == NULL)
+    {
+        UT_LOG("No iccid configured in lpa_config, skipping enable benchmark");
+        return;
+    }
+    if (!perf_profile_listed(profile, "enable"))
+    {
+        return;
+    }
+    perf_measure(PERF_ENABLE_PROFILE, PERF_DISABLE_PROFILE, perf_iterations, perf_warmup, profile, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_enable_profile...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_disable_profile
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 006 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** lpa_config holds at least one valid iccid, installed on the eUICC (skipped otherwise) @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Enable the profile (untimed) then time cellular_esim_disable_profile, LPA_PERF_ITERATIONS times | iccid = first configured iccid, iccid_size = 20 | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_disable_profile(void)
+{
+    char *profile = perf_first_iccid();
+
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_disable_profile...");
+    if (profile == NULL)
+    {
+        UT_LOG("No iccid configured in lpa_config, skipping disable benchmark");
+        return;
+    }
+    if (!perf_profile_listed(profile, "disable"))
+    {
+        return;
+    }
+    perf_measure(PERF_DISABLE_PROFILE, PERF_ENABLE_PROFILE, perf_iterations, perf_warmup, profile, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_disable_profile...");
+}
+
+/**
+* @brief Latency benchmark of the cellular_esim_delete_profile input rejection path
+*
+* Deleting real profiles thousands of times is not possible, so this measures how fast the API rejects an invalid iccid.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 007 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_ITERATIONS times after warm-up with an invalid iccid | iccid = "98414102915071@#0054", iccid_size = 20 | RETURN_ERROR for every call | Should fail |
+*/
+void test_perf_lpa_hal_cellular_esim_delete_profile(void)
+{
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_delete_profile...");
+    perf_measure(PERF_DELETE_PROFILE_REJECT, PERF_API_MAX, perf_iterations, perf_warmup, NULL, RETURN_ERROR);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_delete_profile...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_lpa_init and cellular_esim_lpa_exit
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 008 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Exit (untimed) then time cellular_esim_lpa_init, LPA_PERF_ITERATIONS times | None | RETURN_OK for every call | Should be successful |
+* | 02 | Init (untimed) then time cellular_esim_lpa_exit, LPA_PERF_ITERATIONS times | None | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_lpa_init_exit(void)
+{
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_lpa_init_exit...");
+    perf_measure(PERF_LPA_INIT, PERF_LPA_EXIT, perf_iterations, perf_warmup, NULL, RETURN_OK);
+    perf_measure(PERF_LPA_EXIT, PERF_LPA_INIT, perf_iterations, perf_warmup, NULL, RETURN_OK);
+    /* leave the LPA initialized for the remaining tests of the suite */
+    cellular_esim_lpa_init();
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_lpa_init_exit...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_get_eid
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 009 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_ITERATIONS times after warm-up | None | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_get_eid(void)
+{
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_get_eid...");
+    perf_measure(PERF_GET_EID, PERF_API_MAX, perf_iterations, perf_warmup, NULL, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_get_eid...");
+}
+
+/**
+* @brief Latency benchmark of cellular_esim_get_euicc
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 010 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Invoke the API LPA_PERF_ITERATIONS times after warm-up | None | RETURN_OK for every call | Should be successful |
+*/
+void test_perf_lpa_hal_cellular_esim_get_euicc(void)
+{
+    UT_LOG("Entering test_perf_lpa_hal_cellular_esim_get_euicc...");
+    perf_measure(PERF_GET_EUICC, PERF_API_MAX, perf_iterations, perf_warmup, NULL, RETURN_OK);
+    UT_LOG("Exiting test_perf_lpa_hal_cellular_esim_get_euicc...");
+}
+
+/* Fills `slot` with a 20 digit iccid derived from `seed`, one in four is corrupted (bad digit or check digit) */
+static void perf_make_iccid(char *slot, uint32_t seed)
+{
+    int i = 0;
+
+    memset(slot, 0, LPA_ICCID_SLOT);
+    memcpy(slot, "8901", 4);
+    for (i = 4; i < LPA_ICCID_MAX_DIGITS - 1; i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        slot[i] = (char)('0' + ((seed >> 16) % 10));
+    }
+    slot[LPA_ICCID_MAX_DIGITS - 1] = lpa_iccid_check_digit(slot, LPA_ICCID_MAX_DIGITS - 1);
+    switch ((seed >> 8) % 8)
+    {
+        case 0:
+            slot[7] = '@';
+            break;
+        case 1:
+            slot[LPA_ICCID_MAX_DIGITS - 1] = (char)('0' + ((slot[LPA_ICCID_MAX_DIGITS - 1] - '0' + 1) % 10));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+* @brief Throughput of the packed iccid validation used by scale and fuzz runs
+*
+* Compares the bulk (SIMD when available) digit / length / Luhn kernel with the scalar check and measures
+* packing to BCD plus a packed compare.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 011 @n
+* **Priority:** Low @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Validate LPA_PERF_ICCID_COUNT generated iccids with lpa_iccid_check_slots and with lpa_iccid_check | 3 in 4 valid iccids | Both report the same number of valid iccids | Should be successful |
+* | 02 | Pack every iccid and compare it with the previous one | generated iccids | Throughput printed | Informational |
+*/
+void test_perf_lpa_hal_iccid_bulk_validation(void)
+{
+    size_t count = (size_t)lpa_perf_env_int("LPA_PERF_ICCID_COUNT", 1000000);
+    char *slots = NULL;
+    lpa_iccid_t packed[2];
+    size_t bulk_valid = 0;
+    size_t scalar_valid = 0;
+    size_t equal = 0;
+    uint64_t start = 0;
+    uint64_t bulk_ns = 0;
+    uint64_t scalar_ns = 0;
+    uint64_t pack_ns = 0;
+    size_t i = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_iccid_bulk_validation...");
+    slots = (char *)lpa_arena_alloc(&perf_scratch, count * LPA_ICCID_SLOT);
+    if (slots == NULL)
+    {
+        UT_LOG("Cannot allocate %zu iccid slots, skipping", count);
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    for (i = 0; i < count; i++)
+    {
+        perf_make_iccid(slots + (i * LPA_ICCID_SLOT), (uint32_t)i);
+    }
+
+    start = lpa_perf_now_ns();
+    bulk_valid = lpa_iccid_check_slots(slots, count, LPA_ICCID_SLOT, NULL);
+    bulk_ns = lpa_perf_now_ns() - start;
+
+    start = lpa_perf_now_ns();
+    for (i = 0; i < count; i++)
+    {
+        const char *slot = slots + (i * LPA_ICCID_SLOT);
+        if (lpa_iccid_check(slot, strnlen(slot, LPA_ICCID_SLOT)) == LPA_ICCID_OK)
+        {
+            scalar_valid++;
+        }
+    }
+    scalar_ns = lpa_perf_now_ns() - start;
+
+    start = lpa_perf_now_ns();
+    for (i = 0; i < count; i++)
+    {
+        const char *slot = slots + (i * LPA_ICCID_SLOT);
+        if ((lpa_iccid_pack(slot, strnlen(slot, LPA_ICCID_SLOT), &packed[i % 2]) == LPA_ICCID_OK) &&
+            (lpa_iccid_compare(&packed[0], &packed[1]) == 0))
+        {
+            equal++;
+        }
+    }
+    pack_ns = lpa_perf_now_ns() - start;
+
+    UT_LOG("iccid validation of %zu iccids, %zu valid", count, bulk_valid);
+    UT_LOG("  bulk kernel   : %10.1f ms %8.1f M iccid/s", (double)bulk_ns / 1e6, (double)count / ((double)bulk_ns / 1e3));
+    UT_LOG("  scalar check  : %10.1f ms %8.1f M iccid/s", (double)scalar_ns / 1e6, (double)count / ((double)scalar_ns / 1e3));
+    UT_LOG("  pack + compare: %10.1f ms %8.1f M iccid/s (%zu equal neighbours)", (double)pack_ns / 1e6, (double)count / ((double)pack_ns / 1e3), equal);
+    UT_ASSERT_EQUAL(bulk_valid, scalar_valid);
+    lpa_arena_reset(&perf_scratch);
+    UT_LOG("Exiting test_perf_lpa_hal_iccid_bulk_validation...");
+}
+
+/* Download progress figures accumulated over the iterations of one pass */
+typedef struct
+{
+    lpa_hist_t first_progress;
+    lpa_hist_t total;
+    lpa_hist_t interval;
+    lpa_hist_t callback;
+    uint64_t callbacks;
+    uint64_t blocked_ns;
+    uint64_t elapsed_ns;
+    int on_caller;
+    int errors;
+} perf_progress_t;
+
+/* Runs `iterations` activation code downloads with a callback doing `work_us` of work each time */
+static void perf_progress_pass(perf_progress_t *pass, int iterations, long work_us)
+{
+    lpa_progress_trace_t trace;
+    int timeout_ms = lpa_perf_env_int("LPA_PERF_DOWNLOAD_TIMEOUT_MS", 60000);
+    uint64_t end_ns = 0;
+    int count = 0;
+    int i = 0;
+    int j = 0;
+
+    memset(pass, 0, sizeof(*pass));
+    lpa_hist_reset(&pass->first_progress);
+    lpa_hist_reset(&pass->total);
+    lpa_hist_reset(&pass->interval);
+    lpa_hist_reset(&pass->callback);
+    for (i = 0; i < iterations; i++)
+    {
+        lpa_progress_begin(&trace, work_us);
+        if (cellular_esim_download_profile_with_activationcode((char *)perf_activation_code, lpa_progress_callback) != RETURN_OK)
+        {
+            lpa_progress_end(&trace, 100, 0);
+            pass->errors++;
+            continue;
+        }
+        trace.return_ns = lpa_perf_now_ns();
+        if ((lpa_progress_end(&trace, 100, timeout_ms) != 0) || !trace.monotonic)
+        {
+            pass->errors++;
+        }
+        count = (trace.count < LPA_PROGRESS_MAX) ? trace.count : LPA_PROGRESS_MAX;
+        end_ns = trace.return_ns;
+        if ((count > 0) && (trace.leave_ns[count - 1] > end_ns))
+        {
+            end_ns = trace.leave_ns[count - 1];
+        }
+        lpa_hist_record(&pass->total, end_ns - trace.start_ns);
+        if (count > 0)
+        {
+            lpa_hist_record(&pass->first_progress, trace.enter_ns[0] - trace.start_ns);
+        }
+        for (j = 0; j < count; j++)
+        {
+            if (j > 0)
+            {
+                lpa_hist_record(&pass->interval, trace.enter_ns[j] - trace.enter_ns[j - 1]);
+            }
+            lpa_hist_record(&pass->callback, trace.leave_ns[j] - trace.enter_ns[j]);
+        }
+        pass->callbacks += (uint64_t)trace.count;
+        pass->blocked_ns += lpa_progress_blocked_ns(&trace);
+        pass->elapsed_ns += end_ns - trace.start_ns;
+        pass->on_caller += (trace.on_caller > 0) ? 1 : 0;
+    }
+}
+
+static void perf_progress_print(const char *title, const perf_progress_t *pass)
+{
+    lpa_hist_print_header(title);
+    lpa_hist_print_row("time to first progress", &pass->first_progress, pass->errors);
+    lpa_hist_print_row("interval between callbacks", &pass->interval, 0);
+    lpa_hist_print_row("time inside callback", &pass->callback, 0);
+    lpa_hist_print_row("total download time", &pass->total, pass->errors);
+    if (pass->elapsed_ns > 0)
+    {
+        UT_LOG("%llu callbacks, %.1f callbacks/s, callbacks held the download thread %.1f%% of the time",
+               (unsigned long long)pass->callbacks, (double)pass->callbacks / ((double)pass->elapsed_ns / 1e9),
+               100.0 * (double)pass->blocked_ns / (double)pass->elapsed_ns);
+    }
+}
+
+/**
+* @brief Progress callback instrumentation of cellular_esim_download_profile_with_activationcode
+*
+* Every progress callback is timestamped to report the time to first progress, the callback rate,
+* the total download time and the time spent inside the callback. A second pass makes each callback
+* take LPA_PERF_CALLBACK_WORK_US to measure how much a slow callback delays the download.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 012 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** Network access to the SM-DP+ referenced by the activation code @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Download LPA_PERF_DOWNLOAD_ITERATIONS times with an instrumented callback returning at once | ActivationCodeStr = LPA_PERF_ACTIVATION_CODE | RETURN_OK, progress reaches 100 and never decreases | Should be successful |
+* | 02 | Repeat with a callback taking LPA_PERF_CALLBACK_WORK_US | ActivationCodeStr = LPA_PERF_ACTIVATION_CODE | Added download time against the time spent in callbacks printed | Informational |
+*/
+void test_perf_lpa_hal_download_progress_callback(void)
+{
+    perf_progress_t *fast = NULL;
+    perf_progress_t *slow = NULL;
+    long work_us = lpa_perf_env_uint("LPA_PERF_CALLBACK_WORK_US", 1000);
+    double added_ns = 0.0;
+    double work_ns = 0.0;
+
+    UT_LOG("Entering test_perf_lpa_hal_download_progress_callback...");
+    fast = (perf_progress_t *)lpa_arena_alloc(&perf_scratch, sizeof(perf_progress_t));
+    slow = (perf_progress_t *)lpa_arena_alloc(&perf_scratch, sizeof(perf_progress_t));
+    if ((fast == NULL) || (slow == NULL))
+    {
+        UT_FAIL("perf: progress statistics allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    perf_progress_pass(fast, perf_download_iterations, 0);
+    perf_progress_print("download progress, immediate callback", fast);
+    UT_ASSERT_EQUAL(fast->errors, 0);
+
+    perf_progress_pass(slow, perf_download_iterations, work_us);
+    UT_LOG("callback work %ld us", work_us);
+    perf_progress_print("download progress, slow callback", slow);
+    if ((fast->total.count > 0) && (slow->total.count > 0) && (slow->callbacks > 0))
+    {
+        added_ns = ((double)slow->total.sum / (double)slow->total.count) - ((double)fast->total.sum / (double)fast->total.count);
+        work_ns = ((double)slow->blocked_ns - (double)fast->blocked_ns) / (double)slow->total.count;
+        UT_LOG("slow callback added %.1f us per download for %.1f us of callback work (%.0f%%), callbacks run %s",
+               added_ns / 1e3, work_ns / 1e3, (work_ns > 0.0) ? 100.0 * added_ns / work_ns : 0.0,
+               (slow->on_caller > 0) ? "on the calling thread" : "on a HAL thread");
+    }
+    lpa_arena_reset(&perf_scratch);
+    UT_LOG("Exiting test_perf_lpa_hal_download_progress_callback...");
+}
+
+/* Starts the loopback server once, returns 0 when it is serving */
+static int perf_stub_start(void)
+{
+    lpa_smdp_stub_config_t config;
+
+    if (perf_stub_running)
+    {
+        return 0;
+    }
+    lpa_smdp_stub_default_config(&config);
+    if (lpa_smdp_stub_start(&perf_stub, lpa_perf_env_uint("LPA_SMDP_STUB_PORT", 0), &config) != 0)
+    {
+        UT_LOG("perf: cannot start the loopback SM-DP+ on 127.0.0.1");
+        return -1;
+    }
+    lpa_smdp_stub_address(&perf_stub, perf_stub_address, sizeof(perf_stub_address));
+    snprintf(perf_stub_activation_code, sizeof(perf_stub_activation_code), "1$%s$", perf_stub_address);
+    perf_stub_running = 1;
+    UT_LOG("perf: loopback SM-DS / SM-DP+ listening on %s", perf_stub_address);
+    return 0;
+}
+
+typedef struct
+{
+    const char *name;
+    long delay_us;
+    long bandwidth;
+    long body_bytes;
+    int error_percent;
+} perf_stub_scenario_t;
+
+static const perf_stub_scenario_t perf_stub_scenarios[] =
+{
+    { "no delay",                  0,      0,  2048,  0 },
+    { "20 ms server delay",        20000,  0,  2048,  0 },
+    { "16 KiB at 256 KiB/s",       0,      262144, 16384, 0 },
+    { "10% injected errors",       0,      0,  2048, 10 },
+};
+
+/**
+* @brief Offline download benchmark against the loopback SM-DS / SM-DP+
+*
+* The loopback server is started on 127.0.0.1 and the download APIs are given its "127.0.0.1:<port>"
+* address, so the measurements do not depend on internet access. Each scenario changes the server
+* delay, bandwidth cap or injected error rate.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 013 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** The HAL accepts a host:port server address @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Start the loopback server | 127.0.0.1, LPA_SMDP_STUB_PORT | Server listening | Should be successful |
+* | 02 | For every scenario, time LPA_PERF_DOWNLOAD_ITERATIONS calls of each download API | smds = smdp = "127.0.0.1:<port>" | RETURN_OK for every call of the scenarios without injected errors | Should be successful |
+* | 03 | Scenario with injected errors | error_percent = 10 | Failed calls counted | Informational |
+*/
+void test_perf_lpa_hal_offline_download(void)
+{
+    const perf_api_t apis[] = { PERF_DOWNLOAD_SMDS, PERF_DOWNLOAD_DEFAULTSMDP, PERF_DOWNLOAD_ACTIVATIONCODE };
+    const char *saved_smds = perf_smds;
+    const char *saved_smdp = perf_smdp;
+    const char *saved_code = perf_activation_code;
+    perf_result_t *saved_results = NULL;
+    lpa_smdp_stub_config_t config;
+    perf_result_t *res = NULL;
+    char title[96];
+    int iterations = 0;
+    int warmup = 0;
+    size_t scenario = 0;
+    size_t a = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_offline_download...");
+    if (perf_stub_start() != 0)
+    {
+        UT_FAIL("perf: loopback SM-DP+ unavailable");
+        return;
+    }
+    /* the suite summary keeps the figures of the download benchmarks themselves */
+    saved_results = (perf_result_t *)lpa_arena_alloc(&perf_scratch, sizeof(apis) / sizeof(apis[0]) * sizeof(perf_result_t));
+    if (saved_results == NULL)
+    {
+        UT_FAIL("perf: result allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    for (a = 0; a < sizeof(apis) / sizeof(apis[0]); a++)
+    {
+        saved_results[a] = perf_results[apis[a]];
+    }
+    perf_smds = perf_stub_address;
+    perf_smdp = perf_stub_address;
+    perf_activation_code = perf_stub_activation_code;
+    perf_download_warmup(&iterations, &warmup);
+    for (scenario = 0; scenario < sizeof(perf_stub_scenarios) / sizeof(perf_stub_scenarios[0]); scenario++)
+    {
+        const perf_stub_scenario_t *sc = &perf_stub_scenarios[scenario];
+
+        lpa_smdp_stub_default_config(&config);
+        config.delay_us = sc->delay_us;
+        config.bandwidth = sc->bandwidth;
+        config.body_bytes = sc->body_bytes;
+        config.error_percent = sc->error_percent;
+        lpa_smdp_stub_configure(&perf_stub, &config);
+        snprintf(title, sizeof(title), "offline download, %s", sc->name);
+        lpa_hist_print_header(title);
+        for (a = 0; a < sizeof(apis) / sizeof(apis[0]); a++)
+        {
+            res = &perf_results[apis[a]];
+            /* the injected errors make some calls fail, they are counted rather than asserted */
+            if (sc->error_percent > 0)
+            {
+                perf_run(apis[a], PERF_API_MAX, iterations, 0, NULL, RETURN_OK);
+                lpa_hist_print_row(perf_api_name[apis[a]], &res->hist, res->errors);
+            }
+            else
+            {
+                perf_measure(apis[a], PERF_API_MAX, iterations, warmup, NULL, RETURN_OK);
+            }
+        }
+    }
+    lpa_smdp_stub_default_config(&config);
+    lpa_smdp_stub_configure(&perf_stub, &config);
+    UT_LOG("loopback server: %llu requests, %llu injected errors", (unsigned long long)perf_stub.requests, (unsigned long long)perf_stub.errors);
+    for (a = 0; a < sizeof(apis) / sizeof(apis[0]); a++)
+    {
+        perf_results[apis[a]] = saved_results[a];
+    }
+    lpa_arena_reset(&perf_scratch);
+    perf_smds = saved_smds;
+    perf_smdp = saved_smdp;
+    perf_activation_code = saved_code;
+    UT_LOG("Exiting test_perf_lpa_hal_offline_download...");
+}
+
+/**
+* @brief Repeated cellular_esim_lpa_init / cellular_esim_lpa_exit cycles, cold against warm start and trend
+*
+* The cold init is the first cellular_esim_lpa_init of the process, timed by whichever suite init (or the
+* soak mode) ran first, see lpa_perf_hal_init(). The cycles then give the warm init and exit percentiles, and a table per
+* window of LPA_PERF_CYCLE_WINDOW cycles shows whether the cost or the memory grows over time.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 014 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Time cellular_esim_lpa_exit then cellular_esim_lpa_init, LPA_PERF_CYCLES times | None | RETURN_OK for every call | Should be successful |
+* | 02 | Print cold / first / warm init and exit percentiles | None | Table printed | Informational |
+* | 03 | Print mean and p99 per window with the resident memory, and the init latency slope | None | Trend printed | Informational |
+*/
+void test_perf_lpa_hal_init_exit_cycles(void)
+{
+    int cycles = lpa_perf_env_int("LPA_PERF_CYCLES", 5000);
+    int window = lpa_perf_env_int("LPA_PERF_CYCLE_WINDOW", (cycles >= 20) ? cycles / 10 : 1);
+    lpa_hist_t *hist = NULL;
+    lpa_hist_t *cold = NULL;
+    lpa_hist_t *first = NULL;
+    lpa_hist_t *warm = NULL;
+    lpa_hist_t *exits = NULL;
+    lpa_hist_t *window_init = NULL;
+    lpa_hist_t *window_exit = NULL;
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    double sum_xy = 0.0;
+    double sum_xx = 0.0;
+    double first_mean = 0.0;
+    double mean = 0.0;
+    double slope = 0.0;
+    uint64_t start = 0;
+    uint64_t init_ns = 0;
+    uint64_t exit_ns = 0;
+    long rss_start = lpa_perf_rss_kb();
+    int errors = 0;
+    int i = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_init_exit_cycles...");
+    hist = (lpa_hist_t *)lpa_arena_alloc(&perf_scratch, 6 * sizeof(lpa_hist_t));
+    if (hist == NULL)
+    {
+        UT_FAIL("perf: histogram allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    cold = &hist[0];
+    first = &hist[1];
+    warm = &hist[2];
+    exits = &hist[3];
+    window_init = &hist[4];
+    window_exit = &hist[5];
+    for (i = 0; i < 6; i++)
+    {
+        lpa_hist_reset(&hist[i]);
+    }
+    if (lpa_perf_cold_init_ns() > 0)
+    {
+        lpa_hist_record(cold, lpa_perf_cold_init_ns());
+    }
+
+    UT_LOG("%d init/exit cycles, trend every %d cycles", cycles, window);
+    UT_LOG("%10s %12s %12s %12s %12s %10s", "cycles", "init mean", "init p99", "exit mean", "exit p99", "rss KiB");
+    for (i = 0; i < cycles; i++)
+    {
+        start = lpa_perf_now_ns();
+        if (cellular_esim_lpa_exit() != RETURN_OK)
+        {
+            errors++;
+        }
+        exit_ns = lpa_perf_now_ns() - start;
+        lpa_hist_record(exits, exit_ns);
+        lpa_hist_record(window_exit, exit_ns);
+
+        start = lpa_perf_now_ns();
+        if (cellular_esim_lpa_init() != RETURN_OK)
+        {
+            errors++;
+        }
+        init_ns = lpa_perf_now_ns() - start;
+        lpa_hist_record((i == 0) ? first : warm, init_ns);
+        lpa_hist_record(window_init, init_ns);
+        sum_x += (double)i;
+        sum_y += (double)init_ns;
+        sum_xy += (double)i * (double)init_ns;
+        sum_xx += (double)i * (double)i;
+
+        if (((i + 1) % window == 0) || (i + 1 == cycles))
+        {
+            mean = (double)window_init->sum / (double)window_init->count;
+            if (first_mean == 0.0)
+            {
+                first_mean = mean;
+            }
+            LPA_LOG_INFO("%10d %12.1f %12.1f %12.1f %12.1f %10ld", i + 1, mean / 1e3,
+                         (double)lpa_hist_percentile(window_init, 99.0) / 1e3,
+                         ((double)window_exit->sum / (double)window_exit->count) / 1e3,
+                         (double)lpa_hist_percentile(window_exit, 99.0) / 1e3, lpa_perf_rss_kb());
+            lpa_hist_reset(window_init);
+            lpa_hist_reset(window_exit);
+        }
+    }
+    lpa_log_flush();
+
+    lpa_hist_print_header("init / exit cycles");
+    lpa_hist_print_row("cold init (first of the process)", cold, 0);
+    lpa_hist_print_row("first init after exit", first, 0);
+    lpa_hist_print_row("warm init", warm, 0);
+    lpa_hist_print_row("exit", exits, 0);
+    if ((cycles > 1) && ((double)cycles * sum_xx - sum_x * sum_x) > 0.0)
+    {
+        slope = ((double)cycles * sum_xy - sum_x * sum_y) / ((double)cycles * sum_xx - sum_x * sum_x);
+        UT_LOG("init latency trend %+.3f us per 1000 cycles, resident memory %+ld KiB", slope, lpa_perf_rss_kb() - rss_start);
+    }
+    if ((first_mean > 0.0) && (mean > first_mean * 1.5))
+    {
+        UT_LOG("init latency grew from %.1f us to %.1f us per cycle over the run, state may be leaking across init/exit", first_mean / 1e3, mean / 1e3);
+    }
+    UT_ASSERT_EQUAL(errors, 0);
+    lpa_arena_reset(&perf_scratch);
+    UT_LOG("Exiting test_perf_lpa_hal_init_exit_cycles...");
+}
+
+/* Outcome of polling get_profile_info for the state of one profile */
+typedef struct
+{
+    lpa_hist_t hist;            /* API return until the poll that showed the state returned */
+    uint64_t polls;
+    int first_poll;             /* samples already visible on the first poll */
+    int timeouts;
+    int errors;                 /* the operation or a poll failed */
+} perf_propagation_t;
+
+/* Poll every poll_us until the profile reports `want`, PERF_PROFILE_UNLISTED meaning no longer listed */
+static void perf_propagation_sample(perf_propagation_t *prop, const char *profile, int want, int poll_us, uint64_t timeout_ns)
+{
+    uint64_t returned = lpa_perf_now_ns();
+    uint64_t now = 0;
+    int polls = 0;
+    int state = 0;
+
+    for (;;)
+    {
+        polls++;
+        state = perf_profile_state(profile);
+        if (state == PERF_PROFILE_ERROR)
+        {
+            /* a failed poll says nothing about the state, the sample is dropped */
+            prop->errors++;
+            return;
+        }
+        if (state == want)
+        {
+            now = lpa_perf_now_ns();
+            lpa_hist_record(&prop->hist, now - returned);
+            prop->polls += (uint64_t)polls;
+            if (polls == 1)
+            {
+                prop->first_poll++;
+            }
+            return;
+        }
+        if (lpa_perf_now_ns() - returned >= timeout_ns)
+        {
+            prop->timeouts++;
+            return;
+        }
+        usleep((useconds_t)poll_us);
+    }
+}
+
+static void perf_propagation_print(const char *name, const perf_propagation_t *prop)
+{
+    lpa_hist_print_row(name, &prop->hist, prop->errors + prop->timeouts);
+    if (prop->hist.count > 0)
+    {
+        UT_LOG("%s : %.1f polls per sample, %d of %llu visible on the first poll, %d timeouts", name,
+               (double)prop->polls / (double)prop->hist.count, prop->first_poll,
+               (unsigned long long)prop->hist.count, prop->timeouts);
+    }
+    else if (prop->errors + prop->timeouts > 0)
+    {
+        UT_LOG("%s : no sample, %d errors, %d timeouts", name, prop->errors, prop->timeouts);
+    }
+}
+
+/**
+* @brief Time until cellular_esim_get_profile_info reflects an enable, disable or delete
+*
+* A connection manager polls cellular_esim_get_profile_info after cellular_esim_enable_profile returns
+* until the profile reports profileState 1. After each operation this test polls every LPA_PERF_POLL_US
+* and records the time from the return of the operation until the poll showing the new state
+* returned, as one distribution per operation. Deleting is destructive, so it is only measured, once,
+* on the profile named by LPA_PERF_DELETE_ICCID.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 015 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** lpa_config holds at least one valid iccid, installed on the eUICC (skipped otherwise) @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Enable the profile, then poll cellular_esim_get_profile_info until its profileState is 1, LPA_PERF_PROPAGATION_ROUNDS times | iccid = first configured iccid, iccid_size = 20 | State visible within LPA_PERF_PROPAGATION_TIMEOUT_MS | Should be successful |
+* | 02 | Disable the profile, then poll until its profileState is 0 | iccid = first configured iccid, iccid_size = 20 | State visible within LPA_PERF_PROPAGATION_TIMEOUT_MS | Should be successful |
+* | 03 | Delete the disposable profile, then poll until it is no longer listed | iccid = LPA_PERF_DELETE_ICCID | Profile gone within LPA_PERF_PROPAGATION_TIMEOUT_MS | Skipped when unset |
+*/
+void test_perf_lpa_hal_state_propagation(void)
+{
+    int rounds = lpa_perf_env_int("LPA_PERF_PROPAGATION_ROUNDS", 100);
+    int poll_us = lpa_perf_env_int("LPA_PERF_POLL_US", 100);
+    uint64_t timeout_ns = (uint64_t)lpa_perf_env_int("LPA_PERF_PROPAGATION_TIMEOUT_MS", 5000) * 1000000ULL;
+    const char *disposable = getenv("LPA_PERF_DELETE_ICCID");
+    char *profile = perf_first_iccid();
+    perf_propagation_t *prop = NULL;
+    perf_propagation_t *enable = NULL;
+    perf_propagation_t *disable = NULL;
+    perf_propagation_t *deletion = NULL;
+    int i = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_state_propagation...");
+    if (profile == NULL)
+    {
+        UT_LOG("No iccid configured in lpa_config, skipping state propagation benchmark");
+        return;
+    }
+    if (!perf_profile_listed(profile, "state propagation"))
+    {
+        return;
+    }
+    prop = (perf_propagation_t *)lpa_arena_alloc(&perf_scratch, 3 * sizeof(perf_propagation_t));
+    if (prop == NULL)
+    {
+        UT_FAIL("perf: propagation allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    memset(prop, 0, 3 * sizeof(perf_propagation_t));
+    enable = &prop[0];
+    disable = &prop[1];
+    deletion = &prop[2];
+    for (i = 0; i < 3; i++)
+    {
+        lpa_hist_reset(&prop[i].hist);
+    }
+
+    UT_LOG("%d rounds on %s, polling every %d us", rounds, profile, poll_us);
+    for (i = 0; i < rounds; i++)
+    {
+        if (cellular_esim_enable_profile(profile, PERF_ICCID_SIZE) == RETURN_OK)
+        {
+            perf_propagation_sample(enable, profile, 1, poll_us, timeout_ns);
+        }
+        else
+        {
+            enable->errors++;
+        }
+        if (cellular_esim_disable_profile(profile, PERF_ICCID_SIZE) == RETURN_OK)
+        {
+            perf_propagation_sample(disable, profile, 0, poll_us, timeout_ns);
+        }
+        else
+        {
+            disable->errors++;
+        }
+    }
+    if ((disposable != NULL) && (*disposable != '\0'))
+    {
+        /* a profile has to be disabled before it can be deleted */
+        cellular_esim_disable_profile((char *)disposable, (int)strlen(disposable));
+        if (cellular_esim_delete_profile((char *)disposable, (int)strlen(disposable)) == RETURN_OK)
+        {
+            perf_propagation_sample(deletion, disposable, PERF_PROFILE_UNLISTED, poll_us, timeout_ns);
+        }
+        else
+        {
+            deletion->errors++;
+        }
+    }
+
+    lpa_hist_print_header("state propagation, operation return until get_profile_info shows the state");
+    perf_propagation_print("enable -> profileState 1", enable);
+    perf_propagation_print("disable -> profileState 0", disable);
+    if ((disposable != NULL) && (*disposable != '\0'))
+    {
+        perf_propagation_print("delete -> profile no longer listed", deletion);
+    }
+    else
+    {
+        UT_LOG("delete not measured, set LPA_PERF_DELETE_ICCID to a profile that may be deleted");
+    }
+    UT_ASSERT_EQUAL(enable->errors + enable->timeouts, 0);
+    UT_ASSERT_EQUAL(disable->errors + disable->timeouts, 0);
+    UT_ASSERT_EQUAL(deletion->errors + deletion->timeouts, 0);
+    lpa_arena_reset(&perf_scratch);
+    UT_LOG("Exiting test_perf_lpa_hal_state_propagation...");
+}
+
+/* First configured iccid after `first` that names another profile, NULL when there is none */
+static char *perf_other_iccid(const char *first)
+{
+    int i = 0;
+
+    for (i = 0; i < num_iccid; i++)
+    {
+        if ((iccid[i] != NULL) && (iccid[i][0] != '\0') && (strcmp(iccid[i], first) != 0))
+        {
+            return iccid[i];
+        }
+    }
+    return NULL;
+}
+
+typedef enum
+{
+    PERF_SWITCH_DISABLE = 0,
+    PERF_SWITCH_ENABLE,
+    PERF_SWITCH_CONFIRM,
+    PERF_SWITCH_TOTAL,
+    PERF_SWITCH_A_TO_B,
+    PERF_SWITCH_B_TO_A,
+    PERF_SWITCH_MAX
+} perf_switch_t;
+
+static const char *perf_switch_name[PERF_SWITCH_MAX] =
+{
+    "disable phase",
+    "enable phase",
+    "confirm phase (get_profile_info shows it)",
+    "switch end to end",
+    "switch end to end A -> B",
+    "switch end to end B -> A",
+};
+
+/**
+* @brief Failover switch time between two operator profiles
+*
+* A switch from the active profile to the other one is a cellular_esim_disable_profile of the active
+* profile, a cellular_esim_enable_profile of the other one, and polling cellular_esim_get_profile_info
+* until the new profile reports profileState 1, which is when a gateway can use it. Every cycle switches
+* A -> B then B -> A, and each phase gets its own distribution next to the end to end switch time.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 016 @n
+* **Priority:** High @n
+* @n
+* **Pre-Conditions:** lpa_config holds at least two valid iccids, both installed on the eUICC (skipped otherwise) @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Enable profile A (untimed) | iccid A = first configured iccid | RETURN_OK | Should be successful |
+* | 02 | Switch A -> B: disable A, enable B, poll until B has profileState 1, then B -> A the same way, LPA_PERF_SWITCH_CYCLES times | iccid B = next configured iccid, iccid_size = 20 | RETURN_OK for every call, state visible within LPA_PERF_PROPAGATION_TIMEOUT_MS | Should be successful |
+* | 03 | Print the disable, enable, confirm and end to end distributions | None | Table printed | Informational |
+*/
+void test_perf_lpa_hal_profile_failover(void)
+{
+    int cycles = lpa_perf_env_int("LPA_PERF_SWITCH_CYCLES", 100);
+    int poll_us = lpa_perf_env_int("LPA_PERF_POLL_US", 100);
+    uint64_t timeout_ns = (uint64_t)lpa_perf_env_int("LPA_PERF_PROPAGATION_TIMEOUT_MS", 5000) * 1000000ULL;
+    char *profile_a = perf_first_iccid();
+    char *profile_b = NULL;
+    char *from = NULL;
+    char *to = NULL;
+    lpa_hist_t *hist = NULL;
+    perf_propagation_t confirm;
+    uint64_t start = 0;
+    uint64_t disabled = 0;
+    uint64_t enabled = 0;
+    uint64_t total = 0;
+    int failed = 0;
+    int errors = 0;
+    int i = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_profile_failover...");
+    profile_b = (profile_a != NULL) ? perf_other_iccid(profile_a) : NULL;
+    if (profile_b == NULL)
+    {
+        UT_LOG("Fewer than two iccids configured in lpa_config, skipping failover benchmark");
+        return;
+    }
+    if (!perf_profile_listed(profile_a, "failover") || !perf_profile_listed(profile_b, "failover"))
+    {
+        return;
+    }
+    hist = (lpa_hist_t *)lpa_arena_alloc(&perf_scratch, PERF_SWITCH_MAX * sizeof(lpa_hist_t));
+    if (hist == NULL)
+    {
+        UT_FAIL("perf: histogram allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    for (i = 0; i < PERF_SWITCH_MAX; i++)
+    {
+        lpa_hist_reset(&hist[i]);
+    }
+    memset(&confirm, 0, sizeof(confirm));
+
+    UT_LOG("%d switch cycles, A = %s, B = %s", cycles, profile_a, profile_b);
+    if (cellular_esim_enable_profile(profile_a, PERF_ICCID_SIZE) != RETURN_OK)
+    {
+        UT_FAIL("perf: profile A could not be enabled");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    for (i = 0; i < 2 * cycles; i++)
+    {
+        from = (i % 2 == 0) ? profile_a : profile_b;
+        to = (i % 2 == 0) ? profile_b : profile_a;
+
+        /* a failed call leaves the pair in an unknown state, the next cycle would not be a real switch */
+        start = lpa_perf_now_ns();
+        if (cellular_esim_disable_profile(from, PERF_ICCID_SIZE) != RETURN_OK)
+        {
+            errors++;
+            UT_LOG("disable of %s failed, stopping the failover benchmark", from);
+            break;
+        }
+        disabled = lpa_perf_now_ns();
+        if (cellular_esim_enable_profile(to, PERF_ICCID_SIZE) != RETURN_OK)
+        {
+            errors++;
+            UT_LOG("enable of %s failed, stopping the failover benchmark", to);
+            cellular_esim_enable_profile(from, PERF_ICCID_SIZE);
+            break;
+        }
+        enabled = lpa_perf_now_ns();
+        /* both calls succeeded, a switch that is not confirmed is counted but not timed */
+        lpa_hist_reset(&confirm.hist);
+        failed = confirm.timeouts + confirm.errors;
+        perf_propagation_sample(&confirm, to, 1, poll_us, timeout_ns);
+        if (confirm.timeouts + confirm.errors != failed)
+        {
+            continue;
+        }
+        total = lpa_perf_now_ns() - start;
+        lpa_hist_record(&hist[PERF_SWITCH_DISABLE], disabled - start);
+        lpa_hist_record(&hist[PERF_SWITCH_ENABLE], enabled - disabled);
+        lpa_hist_merge(&hist[PERF_SWITCH_CONFIRM], &confirm.hist);
+        lpa_hist_record(&hist[PERF_SWITCH_TOTAL], total);
+        lpa_hist_record(&hist[(i % 2 == 0) ? PERF_SWITCH_A_TO_B : PERF_SWITCH_B_TO_A], total);
+    }
+
+    lpa_hist_print_header("profile failover, disable the active profile then enable the other one");
+    for (i = 0; i < PERF_SWITCH_MAX; i++)
+    {
+        lpa_hist_print_row(perf_switch_name[i], &hist[i], (i == PERF_SWITCH_TOTAL) ? errors + confirm.timeouts + confirm.errors : 0);
+    }
+    if (hist[PERF_SWITCH_TOTAL].count > 0)
+    {
+        UT_LOG("switch time share: disable %.0f%%, enable %.0f%%, confirm %.0f%%",
+               100.0 * (double)hist[PERF_SWITCH_DISABLE].sum / (double)hist[PERF_SWITCH_TOTAL].sum,
+               100.0 * (double)hist[PERF_SWITCH_ENABLE].sum / (double)hist[PERF_SWITCH_TOTAL].sum,
+               100.0 * (double)hist[PERF_SWITCH_CONFIRM].sum / (double)hist[PERF_SWITCH_TOTAL].sum);
+    }
+    UT_ASSERT_EQUAL(errors, 0);
+    UT_ASSERT_EQUAL(confirm.timeouts + confirm.errors, 0);
+    lpa_arena_reset(&perf_scratch);
+    UT_LOG("Exiting test_perf_lpa_hal_profile_failover...");
+}
+
+#define PERF_SCALE_SIZES_DEFAULT  "1,10,100,1000,10000"
+#define PERF_SCALE_MAX_SIZES      32
+/* Log-log slope past which a size step is reported as super-linear */
+#define PERF_SCALE_SLOPE_LIMIT    1.5
+
+typedef struct
+{
+    int profiles;
+    int returned;
+    int iterations;
+    int errors;
+    int invalid;
+    uint64_t seed_ns;
+    long rss_kb;
+    lpa_hist_t call;
+    lpa_hist_t validate;
+} perf_scale_t;
+
+/* Parses LPA_PERF_SCALE_SIZES, returns the number of sizes kept */
+static int perf_scale_sizes(int *sizes, int max)
+{
+    const char *text = getenv("LPA_PERF_SCALE_SIZES");
+    char *end = NULL;
+    long value = 0;
+    int count = 0;
+
+    if ((text == NULL) || (*text == '\0'))
+    {
+        text = PERF_SCALE_SIZES_DEFAULT;
+    }
+    while ((*text != '\0') && (count < max))
+    {
+        value = strtol(text, &end, 10);
+        if ((end == text) || (value <= 0) || (value > LPA_SYNTH_MAX_PROFILES))
+        {
+            UT_LOG("perf: LPA_PERF_SCALE_SIZES entry \"%s\" ignored, sizes go from 1 to %d", text, LPA_SYNTH_MAX_PROFILES);
+            end = strchr(text, ',');
+            if (end == NULL)
+            {
+                break;
+            }
+        }
+        else
+        {
+            sizes[count++] = (int)value;
+        }
+        text = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+static double perf_scale_slope(const perf_scale_t *from, const perf_scale_t *to, const lpa_hist_t *from_hist, const lpa_hist_t *to_hist)
+{
+    double from_mean = 0.0;
+    double to_mean = 0.0;
+
+    if ((from_hist->count == 0) || (to_hist->count == 0) || (to->profiles <= from->profiles))
+    {
+        return 0.0;
+    }
+    from_mean = (double)from_hist->sum / (double)from_hist->count;
+    to_mean = (double)to_hist->sum / (double)to_hist->count;
+    if ((from_mean <= 0.0) || (to_mean <= 0.0))
+    {
+        return 0.0;
+    }
+    return log(to_mean / from_mean) / log((double)to->profiles / (double)from->profiles);
+}
+
+/* Seeds the eUICC with `count` synthetic profiles and indexes them in the validator */
+static int perf_scale_seed(perf_scale_t *point, char ***names_out)
+{
+    char **names = NULL;
+    char *slots = NULL;
+    char *list = NULL;
+    uint64_t start = 0;
+    int i = 0;
+
+    names = (char **)lpa_arena_alloc(&perf_scratch, (size_t)point->profiles * sizeof(char *));
+    slots = (char *)lpa_arena_alloc(&perf_scratch, (size_t)point->profiles * LPA_ICCID_SLOT);
+    list = lpa_synth_sim_list(point->profiles);
+    if ((names == NULL) || (slots == NULL) || (list == NULL))
+    {
+        free(list);
+        return -1;
+    }
+    for (i = 0; i < point->profiles; i++)
+    {
+        names[i] = &slots[(size_t)i * LPA_ICCID_SLOT];
+        lpa_synth_iccid(i, names[i]);
+    }
+    setenv("LPA_SIM_ICCIDS", list, 1);
+    free(list);
+    if (lpa_validate_build(names, point->profiles, lpa_synth_profile_name, 3) != 0)
+    {
+        return -1;
+    }
+    (void)cellular_esim_lpa_exit();
+    start = lpa_perf_now_ns();
+    if (cellular_esim_lpa_init() != RETURN_OK)
+    {
+        return -1;
+    }
+    point->seed_ns = lpa_perf_now_ns() - start;
+    *names_out = names;
+    return 0;
+}
+
+/* Times get_profile_info and the validation of the list it returns */
+static void perf_scale_measure(perf_scale_t *point, int budget)
+{
+    eSIMProfileStruct *profile_list = NULL;
+    int nb_profiles = 0;
+    uint64_t start = 0;
+    uint64_t returned = 0;
+    int i = 0;
+    int j = 0;
+
+    /* the same order of total work at every size, at least a few samples at the largest */
+    point->iterations = budget / point->profiles;
+    if (point->iterations > perf_iterations)
+    {
+        point->iterations = perf_iterations;
+    }
+    if (point->iterations < 5)
+    {
+        point->iterations = 5;
+    }
+    lpa_hist_reset(&point->call);
+    lpa_hist_reset(&point->validate);
+    for (i = 0; i < point->iterations; i++)
+    {
+        profile_list = NULL;
+        nb_profiles = 0;
+        start = lpa_perf_now_ns();
+        if (cellular_esim_get_profile_info(&profile_list, &nb_profiles) != RETURN_OK)
+        {
+            point->errors++;
+            continue;
+        }
+        returned = lpa_perf_now_ns();
+        lpa_hist_record(&point->call, returned - start);
+        for (j = 0; j < nb_profiles; j++)
+        {
+            if (!lpa_validate_iccid(profile_list[j].iccid) || !lpa_validate_profile_name(profile_list[j].profileName))
+            {
+                point->invalid++;
+            }
+        }
+        lpa_hist_record(&point->validate, lpa_perf_now_ns() - returned);
+        point->returned = nb_profiles;
+        free(profile_list);
+    }
+    point->rss_kb = lpa_perf_rss_kb();
+}
+
+static void perf_scale_report(const perf_scale_t *points, int count)
+{
+    const char *csv_path = getenv("LPA_PERF_SCALE_CSV");
+    FILE *csv = NULL;
+    double call_slope = 0.0;
+    double validate_slope = 0.0;
+    int i = 0;
+
+    UT_LOG("profile count scaling, cellular_esim_get_profile_info and validation of the returned list");
+    UT_LOG("%10s %10s %8s %12s %12s %12s %12s %12s %10s %10s %10s", "profiles", "returned", "samples",
+           "seed us", "call p50 us", "call p99 us", "check p50 us", "bytes", "rss kB", "call slope", "check slope");
+    if ((csv_path != NULL) && (*csv_path != '\0'))
+    {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL)
+        {
+            UT_LOG("perf: cannot write %s", csv_path);
+        }
+        else
+        {
+            fprintf(csv, "profiles,returned,samples,seed_ns,call_mean_ns,call_p50_ns,call_p99_ns,check_mean_ns,check_p50_ns,bytes,rss_kb\n");
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        const perf_scale_t *point = &points[i];
+
+        call_slope = (i > 0) ? perf_scale_slope(&points[i - 1], point, &points[i - 1].call, &point->call) : 0.0;
+        validate_slope = (i > 0) ? perf_scale_slope(&points[i - 1], point, &points[i - 1].validate, &point->validate) : 0.0;
+        UT_LOG("%10d %10d %8llu %12.1f %12.1f %12.1f %12.1f %12llu %10ld %10.2f %10.2f", point->profiles,
+               point->returned, (unsigned long long)point->call.count, (double)point->seed_ns / 1e3,
+               (double)lpa_hist_percentile(&point->call, 50.0) / 1e3,
+               (double)lpa_hist_percentile(&point->call, 99.0) / 1e3,
+               (double)lpa_hist_percentile(&point->validate, 50.0) / 1e3,
+               (unsigned long long)point->returned * sizeof(eSIMProfileStruct), point->rss_kb,
+               call_slope, validate_slope);
+        if (csv != NULL)
+        {
+            fprintf(csv, "%d,%d,%llu,%llu,%.0f,%llu,%llu,%.0f,%llu,%llu,%ld\n", point->profiles, point->returned,
+                    (unsigned long long)point->call.count, (unsigned long long)point->seed_ns,
+                    (point->call.count > 0) ? (double)point->call.sum / (double)point->call.count : 0.0,
+                    (unsigned long long)lpa_hist_percentile(&point->call, 50.0),
+                    (unsigned long long)lpa_hist_percentile(&point->call, 99.0),
+                    (point->validate.count > 0) ? (double)point->validate.sum / (double)point->validate.count : 0.0,
+                    (unsigned long long)lpa_hist_percentile(&point->validate, 50.0),
+                    (unsigned long long)point->returned * sizeof(eSIMProfileStruct), point->rss_kb);
+        }
+        /* small lists are dominated by the fixed cost of the call, only judge the steps between large ones */
+        if ((i > 0) && (points[i - 1].profiles >= 100))
+        {
+            if (call_slope > PERF_SCALE_SLOPE_LIMIT)
+            {
+                UT_LOG("perf: cellular_esim_get_profile_info grows with slope %.2f from %d to %d profiles, worse than linear",
+                       call_slope, points[i - 1].profiles, point->profiles);
+            }
+            if (validate_slope > PERF_SCALE_SLOPE_LIMIT)
+            {
+                UT_LOG("perf: validation grows with slope %.2f from %d to %d profiles, worse than linear",
+                       validate_slope, points[i - 1].profiles, point->profiles);
+            }
+        }
+    }
+    if (csv != NULL)
+    {
+        fclose(csv);
+        UT_LOG("perf: scaling curve written to %s", csv_path);
+    }
+}
+
+/**
+* @brief Scaling of cellular_esim_get_profile_info with the number of profiles on the eUICC
+*
+* For each size of LPA_PERF_SCALE_SIZES the eUICC is filled with that many synthetic profiles, the
+* validator is rebuilt from the same iccids, and cellular_esim_get_profile_info is timed together
+* with the validation of the list it returns. Every row also reports the bytes returned and the
+* process RSS, and the log-log slope against the previous size: 1 is linear, 2 quadratic. The
+* simulator is seeded through LPA_SIM_ICCIDS; a vendor HAL keeps its own profiles, and the returned
+* column then shows what was actually measured.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 017 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | For each size, seed the profiles and re-initialise with cellular_esim_lpa_exit / cellular_esim_lpa_init | LPA_SIM_ICCIDS = generated iccids | RETURN_OK | Should be successful |
+* | 02 | Time cellular_esim_get_profile_info and the validation of every returned iccid and profile name | Samples scaled down with the size | RETURN_OK, every profile valid | Should be successful |
+* | 03 | Print the scaling table, optionally as CSV to LPA_PERF_SCALE_CSV, then restore the configured profiles | None | Table printed | Informational |
+*/
+void test_perf_lpa_hal_profile_scaling(void)
+{
+    int sizes[PERF_SCALE_MAX_SIZES];
+    int budget = lpa_perf_env_int("LPA_PERF_SCALE_BUDGET", 100000);
+    char *saved_iccids = NULL;
+    char *saved_config = NULL;
+    char **names = NULL;
+    perf_scale_t *points = NULL;
+    int count = 0;
+    int done = 0;
+    int errors = 0;
+    int invalid = 0;
+    int i = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_profile_scaling...");
+    count = perf_scale_sizes(sizes, PERF_SCALE_MAX_SIZES);
+    if (count == 0)
+    {
+        UT_LOG("perf: no valid size in LPA_PERF_SCALE_SIZES, skipping scaling benchmark");
+        return;
+    }
+    points = (perf_scale_t *)lpa_arena_alloc(&perf_scratch, (size_t)count * sizeof(perf_scale_t));
+    if (points == NULL)
+    {
+        UT_FAIL("perf: scaling table allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    memset(points, 0, (size_t)count * sizeof(perf_scale_t));
+    /* the generated profiles replace the configured ones for the sweep only */
+    if (getenv("LPA_SIM_ICCIDS") != NULL)
+    {
+        saved_iccids = strdup(getenv("LPA_SIM_ICCIDS"));
+    }
+    if (getenv("LPA_SIM_CONFIG") != NULL)
+    {
+        saved_config = strdup(getenv("LPA_SIM_CONFIG"));
+        unsetenv("LPA_SIM_CONFIG");
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        points[i].profiles = sizes[i];
+        if (perf_scale_seed(&points[i], &names) != 0)
+        {
+            UT_LOG("perf: %d profiles could not be seeded, sweep stopped", sizes[i]);
+            errors++;
+            break;
+        }
+        perf_scale_measure(&points[i], budget);
+        if (points[i].returned != points[i].profiles)
+        {
+            UT_LOG("perf: %d profiles seeded, cellular_esim_get_profile_info returned %d", points[i].profiles, points[i].returned);
+        }
+        errors += points[i].errors;
+        invalid += points[i].invalid;
+        done++;
+    }
+    perf_scale_report(points, done);
+
+    if (saved_iccids != NULL)
+    {
+        setenv("LPA_SIM_ICCIDS", saved_iccids, 1);
+    }
+    else
+    {
+        unsetenv("LPA_SIM_ICCIDS");
+    }
+    if (saved_config != NULL)
+    {
+        setenv("LPA_SIM_CONFIG", saved_config, 1);
+    }
+    free(saved_iccids);
+    free(saved_config);
+    lpa_arena_reset(&perf_scratch);
+    /* the validator holds the generated iccids, lpa_config is loaded again on its next use */
+    freeiccid();
+    (void)cellular_esim_lpa_exit();
+    if (cellular_esim_lpa_init() != RETURN_OK)
+    {
+        UT_FAIL("perf: configured profiles could not be restored after the sweep");
+    }
+    UT_ASSERT_EQUAL(errors, 0);
+    UT_ASSERT_EQUAL(invalid, 0);
+    UT_LOG("Exiting test_perf_lpa_hal_profile_scaling...");
+}
+
+#define PERF_CONFIG_FILE        "lpa_perf_config"
+#define PERF_CONFIG_CACHE_FILE  "lpa_perf_config.cache"
+
+typedef enum
+{
+    PERF_CONFIG_PARSE = 0,
+    PERF_CONFIG_HASH,
+    PERF_CONFIG_COMPILE,
+    PERF_CONFIG_MAP,
+    PERF_CONFIG_MAX
+} perf_config_t;
+
+static const char *perf_config_name[PERF_CONFIG_MAX] =
+{
+    "parse lpa_config (json)",
+    "hash lpa_config (touched file)",
+    "compile the cache",
+    "map the cache",
+};
+
+static int perf_config_count(void *ctx, lpa_strview_t key, int index, lpa_strview_t value)
+{
+    (void)value;
+    if ((index >= 0) && (strcmp(key.ptr, "iccid") == 0))
+    {
+        (*(int *)ctx)++;
+    }
+    return 0;
+}
+
+/**
+* @brief Start-up cost of lpa_config: json parse against the mapped binary cache
+*
+* A synthetic lpa_config of LPA_PERF_CONFIG_PROFILES iccids is written to the working directory. Each
+* round parses it the way the suite does without a cache, hashes it as when its mtime changed, and
+* maps the compiled cache and walks every slot, which is the whole cost of a start with a current cache.
+* The one-off compile is timed separately.
+*
+* **Test Group ID:** Performance: 02 @n
+* **Test Case ID:** 018 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** The working directory is writable @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Write a synthetic lpa_config and compile its cache | LPA_PERF_CONFIG_PROFILES iccids | Both files written | Should be successful |
+* | 02 | Parse, hash, and map the cache LPA_PERF_CONFIG_LOADS times | None | Every load finds all the iccids | Should be successful |
+* | 03 | Print the distributions and remove both files | None | Table printed | Informational |
+*/
+void test_perf_lpa_hal_config_cache(void)
+{
+    int profiles = lpa_perf_env_int("LPA_PERF_CONFIG_PROFILES", 10000);
+    int loads = lpa_perf_env_int("LPA_PERF_CONFIG_LOADS", 50);
+    lpa_hist_t *hist = NULL;
+    char **names = NULL;
+    char *slots = NULL;
+    lpa_config_t config;
+    lpa_config_source_t source;
+    lpa_config_cache_t cache;
+    uint64_t start = 0;
+    size_t walked = 0;
+    int errors = 0;
+    int count = 0;
+    int i = 0;
+    uint32_t j = 0;
+
+    UT_LOG("Entering test_perf_lpa_hal_config_cache...");
+    if (profiles > LPA_SYNTH_MAX_PROFILES)
+    {
+        profiles = LPA_SYNTH_MAX_PROFILES;
+    }
+    hist = (lpa_hist_t *)lpa_arena_alloc(&perf_scratch, PERF_CONFIG_MAX * sizeof(lpa_hist_t));
+    names = (char **)lpa_arena_alloc(&perf_scratch, (size_t)profiles * sizeof(char *));
+    slots = (char *)lpa_arena_alloc(&perf_scratch, (size_t)profiles * LPA_ICCID_SLOT);
+    if ((hist == NULL) || (names == NULL) || (slots == NULL))
+    {
+        UT_FAIL("perf: config benchmark allocation failed");
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    for (i = 0; i < PERF_CONFIG_MAX; i++)
+    {
+        lpa_hist_reset(&hist[i]);
+    }
+    for (i = 0; i < profiles; i++)
+    {
+        names[i] = &slots[(size_t)i * LPA_ICCID_SLOT];
+        lpa_synth_iccid(i, names[i]);
+    }
+    if ((lpa_synth_write_config(PERF_CONFIG_FILE, profiles) != 0) ||
+        (lpa_config_cache_source(PERF_CONFIG_FILE, &source) != LPA_CONFIG_OK) ||
+        (lpa_config_open(&config, PERF_CONFIG_FILE) != LPA_CONFIG_OK))
+    {
+        UT_LOG("perf: %s cannot be written, skipping config benchmark", PERF_CONFIG_FILE);
+        unlink(PERF_CONFIG_FILE);
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    /* no cache yet: the call only hashes the text */
+    (void)lpa_config_cache_open(&cache, PERF_CONFIG_CACHE_FILE, &source, &config);
+    lpa_config_close(&config);
+    start = lpa_perf_now_ns();
+    if (lpa_config_cache_write(PERF_CONFIG_CACHE_FILE, &source, names, profiles, (char **)lpa_synth_profile_name, 3) != 0)
+    {
+        UT_FAIL("perf: the cache could not be compiled");
+        unlink(PERF_CONFIG_FILE);
+        lpa_arena_reset(&perf_scratch);
+        return;
+    }
+    lpa_hist_record(&hist[PERF_CONFIG_COMPILE], lpa_perf_now_ns() - start);
+
+    UT_LOG("%d loads of an lpa_config with %d iccids", loads, profiles);
+    for (i = 0; i < loads; i++)
+    {
+        count = 0;
+        start = lpa_perf_now_ns();
+        if ((lpa_config_open(&config, PERF_CONFIG_FILE) != LPA_CONFIG_OK) ||
+            (lpa_config_parse(&config, perf_config_count, &count) != LPA_CONFIG_OK))
+        {
+            errors++;
+        }
+        lpa_config_close(&config);
+        lpa_hist_record(&hist[PERF_CONFIG_PARSE], lpa_perf_now_ns() - start);
+        errors += (count != profiles);
+
+        /* a cache path that cannot open: the call only hashes the text */
+        source.hashed = 0;
+        start = lpa_perf_now_ns();
+        if (lpa_config_open(&config, PERF_CONFIG_FILE) == LPA_CONFIG_OK)
+        {
+            (void)lpa_config_cache_open(&cache, "/nonexistent/" PERF_CONFIG_CACHE_FILE, &source, &config);
+        }
+        lpa_config_close(&config);
+        lpa_hist_record(&hist[PERF_CONFIG_HASH], lpa_perf_now_ns() - start);
+
+        walked = 0;
+        start = lpa_perf_now_ns();
+        if (lpa_config_cache_open(&cache, PERF_CONFIG_CACHE_FILE, &source, NULL) != 0)
+        {
+            errors++;
+            continue;
+        }
+        for (j = 0; j < cache.header->nb_iccid; j++)
+        {
+            walked += (lpa_config_cache_iccid(&cache, j)[0] != '\0');
+        }
+        lpa_config_cache_close(&cache);
+        lpa_hist_record(&hist[PERF_CONFIG_MAP], lpa_perf_now_ns() - start);
+        errors += (walked != (size_t)profiles);
+    }
+
+    lpa_hist_print_header("lpa_config load, json parse against the mapped cache");
+    for (i = 0; i < PERF_CONFIG_MAX; i++)
+    {
+        lpa_hist_print_row(perf_config_name[i], &hist[i], (i == PERF_CONFIG_MAP) ? errors : 0);
+    }
+    if ((hist[PERF_CONFIG_PARSE].count > 0) && (hist[PERF_CONFIG_MAP].count > 0) && (hist[PERF_CONFIG_MAP].sum > 0))
+    {
+        UT_LOG("mapping the cache is %.1fx faster than parsing",
+               ((double)hist[PERF_CONFIG_PARSE].sum / (double)hist[PERF_CONFIG_PARSE].count) /
+               ((double)hist[PERF_CONFIG_MAP].sum / (double)hist[PERF_CONFIG_MAP].count));
+    }
+    unlink(PERF_CONFIG_FILE);
+    unlink(PERF_CONFIG_CACHE_FILE);
+    UT_ASSERT_EQUAL(errors, 0);
+    lpa_arena_reset(&perf_scratch);
+    UT_LOG("Exiting test_perf_lpa_hal_config_cache...");
+}
+
+static int init_perf_lpa_hal(void)
+{
+    int i = 0;
+
+    perf_iterations = lpa_perf_env_int("LPA_PERF_ITERATIONS", 1000);
+    perf_warmup = lpa_perf_env_uint("LPA_PERF_WARMUP", 100);
+    perf_download_iterations = lpa_perf_env_int("LPA_PERF_DOWNLOAD_ITERATIONS", 100);
+    perf_activation_code = getenv("LPA_PERF_ACTIVATION_CODE");
+    if (perf_activation_code == NULL)
+    {
+        perf_activation_code = "1$smdp-plus.test.gsma.com$";
+    }
+    /* air-gapped runs: every download benchmark talks to the loopback server */
+    if ((lpa_perf_env_uint("LPA_PERF_OFFLINE", 0) == 1) && (perf_stub_start() == 0))
+    {
+        perf_smds = perf_stub_address;
+        perf_smdp = perf_stub_address;
+        perf_activation_code = perf_stub_activation_code;
+    }
+    for (i = 0; i < PERF_API_MAX; i++)
+    {
+        lpa_hist_reset(&perf_results[i].hist);
+        perf_results[i].errors = 0;
+    }
+    lpa_arena_init(&perf_scratch, 0);
+    UT_LOG("perf: iterations %d, warm-up %d, download iterations %d", perf_iterations, perf_warmup, perf_download_iterations);
+    if (lpa_perf_hal_init() != RETURN_OK)
+    {
+        UT_LOG("celular_esim init returned failure");
+        UT_FAIL_FATAL("celular_esim  initialization failed");
+    }
+    return 0;
+}
+
+static int clean_perf_lpa_hal(void)
+{
+    int i = 0;
+
+    lpa_hist_print_header("[L1 lpa_hal perf] summary");
+    for (i = 0; i < PERF_API_MAX; i++)
+    {
+        lpa_hist_print_row(perf_api_name[i], &perf_results[i].hist, perf_results[i].errors);
+    }
+    lpa_arena_destroy(&perf_scratch);
+    if (perf_stub_running)
+    {
+        lpa_smdp_stub_stop(&perf_stub);
+        perf_stub_running = 0;
+    }
+    if (cellular_esim_lpa_exit() != RETURN_OK)
+    {
+        UT_LOG("celular_esim exit returned failure");
+        UT_FAIL_FATAL("celular_esim exit failed");
+    }
+    return 0;
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the performance tests for this module
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_lpa_hal_perf_register(void)
+{
+    pSuite = UT_add_suite("[L1 lpa_hal perf]", init_perf_lpa_hal, clean_perf_lpa_hal);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_download_profile_with_activationcode", test_perf_lpa_hal_cellular_esim_download_profile_with_activationcode);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_download_profile_from_smds", test_perf_lpa_hal_cellular_esim_download_profile_from_smds);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_download_profile_from_defaultsmdp", test_perf_lpa_hal_cellular_esim_download_profile_from_defaultsmdp);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_get_profile_info", test_perf_lpa_hal_cellular_esim_get_profile_info);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_enable_profile", test_perf_lpa_hal_cellular_esim_enable_profile);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_disable_profile", test_perf_lpa_hal_cellular_esim_disable_profile);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_delete_profile", test_perf_lpa_hal_cellular_esim_delete_profile);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_lpa_init_exit", test_perf_lpa_hal_cellular_esim_lpa_init_exit);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_get_eid", test_perf_lpa_hal_cellular_esim_get_eid);
+    UT_add_test( pSuite, "perf_lpa_hal_cellular_esim_get_euicc", test_perf_lpa_hal_cellular_esim_get_euicc);
+    UT_add_test( pSuite, "perf_lpa_hal_iccid_bulk_validation", test_perf_lpa_hal_iccid_bulk_validation);
+    UT_add_test( pSuite, "perf_lpa_hal_download_progress_callback", test_perf_lpa_hal_download_progress_callback);
+    UT_add_test( pSuite, "perf_lpa_hal_offline_download", test_perf_lpa_hal_offline_download);
+    UT_add_test( pSuite, "perf_lpa_hal_init_exit_cycles", test_perf_lpa_hal_init_exit_cycles);
+    UT_add_test( pSuite, "perf_lpa_hal_state_propagation", test_perf_lpa_hal_state_propagation);
+    UT_add_test( pSuite, "perf_lpa_hal_profile_failover", test_perf_lpa_hal_profile_failover);
+    UT_add_test( pSuite, "perf_lpa_hal_profile_scaling", test_perf_lpa_hal_profile_scaling);
+    UT_add_test( pSuite, "perf_lpa_hal_config_cache", test_perf_lpa_hal_config_cache);
+    return 0;
+}
@@ -18,12 +18,16 @@
 
 /* L1 Testing Functions */
 extern int test_lpa_hal_l1_register(void);
+extern int test_lpa_hal_perf_register(void);
+extern int test_lpa_hal_stress_register(void);
  
 int register_hal_l1_tests( void )
 {
     int registerFailed=0;
 
     registerFailed |= test_lpa_hal_l1_register();
+    registerFailed |= test_lpa_hal_perf_register();
+    registerFailed |= test_lpa_hal_stress_register();
  
     return registerFailed;
 }
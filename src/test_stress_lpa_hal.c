@@ -0,0 +1,345 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_stress_lpa_hal.c
+* @page lpa_hal_stress Contention Stress Tests
+*
+* ## Module's Role
+* This module calls cellular_esim_get_profile_info, cellular_esim_enable_profile and cellular_esim_disable_profile
+* from N threads at the same time, the way several daemons share the LPA in production.
+* The run is repeated for 1, 2, 4 ... LPA_STRESS_THREADS threads and the throughput and per-call latency are
+* reported against the thread count. A speedup that stays close to 1 shows that the vendor library serializes
+* every call behind one lock.
+*
+* **Pre-Conditions:**  lpa_config populated with valid iccid values for the enable/disable part of the mix@n
+* **Dependencies:** None@n
+*
+* Tuning (environment):
+* - LPA_STRESS_THREADS : highest thread count of the sweep (default 8)
+* - LPA_STRESS_CALLS : calls issued by every thread for each thread count (default 500)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "lpa_hal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "lpa_perf.h"
+
+extern int num_iccid;
+extern char** iccid;
+extern int require_iccid(void);
+
+#define STRESS_ICCID_SIZE 20
+
+typedef enum
+{
+    STRESS_GET_PROFILE_INFO = 0,
+    STRESS_ENABLE_PROFILE,
+    STRESS_DISABLE_PROFILE,
+    STRESS_OP_MAX
+} stress_op_t;
+
+static const char *stress_op_name[STRESS_OP_MAX] =
+{
+    "cellular_esim_get_profile_info",
+    "cellular_esim_enable_profile",
+    "cellular_esim_disable_profile",
+};
+
+typedef struct
+{
+    lpa_hist_t hist[STRESS_OP_MAX];
+    int errors[STRESS_OP_MAX];
+} stress_stats_t;
+
+/* Holds every worker until all of them are created, so the clock starts with the full load */
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int open;
+} stress_gate_t;
+
+typedef struct
+{
+    pthread_t thread;
+    stress_gate_t *gate;
+    char *profile;
+    int calls;
+    stress_stats_t stats;
+} stress_worker_t;
+
+static int stress_max_threads = 0;
+static int stress_calls = 0;
+
+/* Configured iccids that are not empty, the threads spread their enable/disable calls over them */
+static int stress_usable_iccids(char **out, int max)
+{
+    int n = 0;
+    int i = 0;
+
+    if (require_iccid() != 0)
+    {
+        return 0;
+    }
+    for (i = 0; (i < num_iccid) && (n < max); i++)
+    {
+        if ((iccid[i] != NULL) && (iccid[i][0] != '\0'))
+        {
+            out[n++] = iccid[i];
+        }
+    }
+    return n;
+}
+
+static void *stress_worker(void *arg)
+{
+    stress_worker_t *worker = (stress_worker_t *)arg;
+    eSIMProfileStruct *profile_list = NULL;
+    int nb_profiles = 0;
+    uint64_t start = 0;
+    int result = 0;
+    int op = 0;
+    int i = 0;
+
+    for (op = 0; op < STRESS_OP_MAX; op++)
+    {
+        lpa_hist_reset(&worker->stats.hist[op]);
+        worker->stats.errors[op] = 0;
+    }
+    pthread_mutex_lock(&worker->gate->lock);
+    while (!worker->gate->open)
+    {
+        pthread_cond_wait(&worker->gate->cond, &worker->gate->lock);
+    }
+    pthread_mutex_unlock(&worker->gate->lock);
+
+    for (i = 0; i < worker->calls; i++)
+    {
+        /* get_profile_info only when there is no profile to switch, otherwise a get / enable / disable round robin */
+        op = (worker->profile == NULL) ? STRESS_GET_PROFILE_INFO : (i % STRESS_OP_MAX);
+        start = lpa_perf_now_ns();
+        switch (op)
+        {
+            case STRESS_ENABLE_PROFILE:
+                result = cellular_esim_enable_profile(worker->profile, STRESS_ICCID_SIZE);
+                break;
+            case STRESS_DISABLE_PROFILE:
+                result = cellular_esim_disable_profile(worker->profile, STRESS_ICCID_SIZE);
+                break;
+            default:
+                profile_list = NULL;
+                result = cellular_esim_get_profile_info(&profile_list, &nb_profiles);
+                break;
+        }
+        lpa_hist_record(&worker->stats.hist[op], lpa_perf_now_ns() - start);
+        if (op == STRESS_GET_PROFILE_INFO)
+        {
+            free(profile_list);
+        }
+        if (result != RETURN_OK)
+        {
+            worker->stats.errors[op]++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run `threads` workers concurrently, merge their statistics into `total`
+ *
+ * @return wall clock time of the run in nanoseconds, 0 if the threads could not be started
+ */
+static uint64_t stress_run(int threads, char **profiles, int nb_profiles, stress_stats_t *total)
+{
+    stress_worker_t *workers = NULL;
+    stress_gate_t gate = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0 };
+    uint64_t start = 0;
+    uint64_t elapsed = 0;
+    int started = 0;
+    int op = 0;
+    int i = 0;
+
+    for (op = 0; op < STRESS_OP_MAX; op++)
+    {
+        lpa_hist_reset(&total->hist[op]);
+        total->errors[op] = 0;
+    }
+    workers = (stress_worker_t *)calloc((size_t)threads, sizeof(stress_worker_t));
+    if (workers == NULL)
+    {
+        return 0;
+    }
+    for (i = 0; i < threads; i++)
+    {
+        workers[i].gate = &gate;
+        workers[i].calls = stress_calls;
+        workers[i].profile = (nb_profiles > 0) ? profiles[i % nb_profiles] : NULL;
+        if (pthread_create(&workers[i].thread, NULL, stress_worker, &workers[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started != threads)
+    {
+        UT_LOG("stress: only %d of %d threads could be started", started, threads);
+    }
+    pthread_mutex_lock(&gate.lock);
+    gate.open = 1;
+    start = lpa_perf_now_ns();
+    pthread_cond_broadcast(&gate.cond);
+    pthread_mutex_unlock(&gate.lock);
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    elapsed = lpa_perf_now_ns() - start;
+
+    for (i = 0; i < started; i++)
+    {
+        for (op = 0; op < STRESS_OP_MAX; op++)
+        {
+            lpa_hist_merge(&total->hist[op], &workers[i].stats.hist[op]);
+            total->errors[op] += workers[i].stats.errors[op];
+        }
+    }
+    free(workers);
+    return (started == threads) ? elapsed : 0;
+}
+
+/**
+* @brief Contention stress test of get_profile_info / enable / disable
+*
+* The call mix is issued from 1, 2, 4 ... LPA_STRESS_THREADS threads released together.
+* Throughput, speedup over one thread and per-call latency percentiles are reported for every thread count.
+*
+* **Test Group ID:** Stress: 03 @n
+* **Test Case ID:** 001 @n
+* **Priority:** Medium @n
+* @n
+* **Pre-Conditions:** lpa_config holds at least one valid iccid, otherwise only get_profile_info is stressed @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01 | Start N threads, each issuing LPA_STRESS_CALLS calls of the get / enable / disable mix | iccid = configured iccids, iccid_size = 20 | cellular_esim_get_profile_info returns RETURN_OK for every call | Should be successful |
+* | 02 | Repeat with N doubled up to LPA_STRESS_THREADS and report throughput against N | None | Throughput table printed | Informational |
+*/
+void test_stress_lpa_hal_concurrent_profile_operations(void)
+{
+    char *profiles[64];
+    int nb_profiles = stress_usable_iccids(profiles, (int)(sizeof(profiles) / sizeof(profiles[0])));
+    stress_stats_t *stats = NULL;
+    double base_rate = 0.0;
+    double rate = 0.0;
+    uint64_t elapsed = 0;
+    int threads = 1;
+    int op = 0;
+
+    UT_LOG("Entering test_stress_lpa_hal_concurrent_profile_operations...");
+    if (nb_profiles == 0)
+    {
+        UT_LOG("No iccid configured in lpa_config, stressing cellular_esim_get_profile_info only");
+    }
+    stats = (stress_stats_t *)malloc(sizeof(stress_stats_t));
+    if (stats == NULL)
+    {
+        UT_FAIL("stress: statistics allocation failed");
+        return;
+    }
+    UT_LOG("%8s %10s %10s %12s %8s %10s", "threads", "calls", "wall ms", "calls/s", "speedup", "efficiency");
+    while (threads <= stress_max_threads)
+    {
+        elapsed = stress_run(threads, profiles, nb_profiles, stats);
+        if (elapsed == 0)
+        {
+            UT_FAIL("stress: worker threads could not be started");
+            break;
+        }
+        rate = ((double)threads * (double)stress_calls) / ((double)elapsed / 1e9);
+        if (threads == 1)
+        {
+            base_rate = rate;
+        }
+        UT_LOG("%8d %10d %10.1f %12.0f %8.2f %9.0f%%", threads, threads * stress_calls, (double)elapsed / 1e6,
+               rate, rate / base_rate, 100.0 * (rate / base_rate) / (double)threads);
+        for (op = 0; op < STRESS_OP_MAX; op++)
+        {
+            lpa_hist_print_row(stress_op_name[op], &stats->hist[op], stats->errors[op]);
+        }
+        UT_ASSERT_EQUAL(stats->errors[STRESS_GET_PROFILE_INFO], 0);
+
+        if (threads == stress_max_threads)
+        {
+            break;
+        }
+        threads = (threads * 2 > stress_max_threads) ? stress_max_threads : threads * 2;
+    }
+    if ((threads >= 4) && (base_rate > 0.0) && (rate / base_rate < 1.2))
+    {
+        UT_LOG("stress: throughput does not scale with threads (speedup %.2f at %d threads), calls look serialized behind a single lock", rate / base_rate, threads);
+    }
+    free(stats);
+    UT_LOG("Exiting test_stress_lpa_hal_concurrent_profile_operations...");
+}
+
+static int init_stress_lpa_hal(void)
+{
+    stress_max_threads = lpa_perf_env_int("LPA_STRESS_THREADS", 8);
+    stress_calls = lpa_perf_env_int("LPA_STRESS_CALLS", 500);
+    UT_LOG("stress: up to %d threads, %d calls per thread", stress_max_threads, stress_calls);
+    if (lpa_perf_hal_init() != RETURN_OK)
+    {
+        UT_LOG("celular_esim init returned failure");
+        UT_FAIL_FATAL("celular_esim  initialization failed");
+    }
+    return 0;
+}
+
+static int clean_stress_lpa_hal(void)
+{
+    if (cellular_esim_lpa_exit() != RETURN_OK)
+    {
+        UT_LOG("celular_esim exit returned failure");
+        UT_FAIL_FATAL("celular_esim exit failed");
+    }
+    return 0;
+}
+
+static UT_test_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the stress tests for this module
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_lpa_hal_stress_register(void)
+{
+    pSuite = UT_add_suite("[L1 lpa_hal stress]", init_stress_lpa_hal, clean_stress_lpa_hal);
+    if (pSuite == NULL) {
+        return -1;
+    }
+    UT_add_test( pSuite, "stress_lpa_hal_concurrent_profile_operations", test_stress_lpa_hal_concurrent_profile_operations);
+    return 0;
+}